@@ -0,0 +1,169 @@
+/**
+ * @file arena.c Functions on the arena
+ * @author Valentin Koeltgen
+ *
+ * This file contain the allocator of the temporaries of a command: matrices, polynomials and syntax trees calculated
+ * during a command are allocated one after the other in chunks, and are all freed at once when the command ends. The
+ * blocks kept after the command are allocated in the pool
+ */
+
+#define ALLOCATION_IMPLEMENTATION
+#include "arena.h"
+#include <stdint.h>
+
+Arena commandArena = {NULL, 0, 0, 0, NULL, 0, 0, 0};
+
+/**
+ * First byte of the blocks of a chunk
+ * @param chunk - The chunk
+ * @return start of the blocks
+ */
+char *chunkData(ArenaChunk *chunk) {
+    return (char *) (chunk + 1);
+}
+
+/**
+ * Header of a block of a chunk
+ * @param block - The block
+ * @return header just before the values
+ */
+ArenaBlock *blockHeader(void *block) {
+    return (ArenaBlock *) block - 1;
+}
+
+/**
+ * Search for a large block
+ * The recent blocks are searched first, they are the ones usually freed
+ * @param block - The block
+ * @return index of the block in the list of large blocks, -1 if it isn't a large block
+ */
+int searchLarge(const void *block) {
+    for (int i = commandArena.nbLarge - 1; i >= 0; i--) {
+        if (commandArena.large[i] == block) return i;
+    }
+    return -1;
+}
+
+/**
+ * Search for the chunk containing a block
+ * @param block - The block
+ * @return the chunk, NULL if the block isn't in a chunk
+ */
+ArenaChunk *searchChunk(const void *block) {
+    for (ArenaChunk *chunk = commandArena.chunk; chunk; chunk = chunk->previous) {
+        if ((const char *) block > chunkData(chunk) && (const char *) block < chunkData(chunk) + chunk->used) return chunk;
+    }
+    return NULL;
+}
+
+/**
+ * Allocate a block in the arena
+ * @param size - Number of bytes
+ * @return the block, NULL if the arena is full
+ */
+void *arenaAllocate(size_t size) {
+    if (size >= ARENA_LARGE_SIZE) { //Large blocks are freed on their own, they would waste the end of a chunk
+        if (commandArena.nbLarge == commandArena.capacity) {
+            commandArena.capacity = commandArena.capacity ? 2 * commandArena.capacity : 64;
+            commandArena.large = realloc(commandArena.large, commandArena.capacity * sizeof(void *));
+        }
+        return commandArena.large[commandArena.nbLarge++] = poolMalloc(size);
+    }
+    if (!size) size = 1; //Empty blocks take a byte so that they are found in their chunk
+    ArenaChunk *chunk = commandArena.chunk;
+    if (!chunk || chunk->used + sizeof(ArenaBlock) + ARENA_ALIGNMENT + size > chunk->capacity) { //The chunk is full, a larger one is added
+        size_t capacity = chunk ? 2 * chunk->capacity : ARENA_CHUNK_SIZE;
+        //A command freeing its temporaries while it runs longer would keep them all until its end
+        if (commandArena.size + capacity > ARENA_MAX_SIZE) return NULL;
+        commandArena.size += capacity;
+        ArenaChunk *next = malloc(sizeof(ArenaChunk) + capacity);
+        *next = (ArenaChunk) {chunk, capacity, 0};
+        commandArena.chunk = chunk = next;
+    }
+    //The header is written in the padding before the aligned block
+    char *start = chunkData(chunk) + chunk->used;
+    char *block = (char *) (((uintptr_t) start + sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) & ~(uintptr_t) (ARENA_ALIGNMENT - 1));
+    *blockHeader(block) = (ArenaBlock) {(unsigned int) size, (unsigned int) (block - start)};
+    chunk->used = block + size - chunkData(chunk);
+    commandArena.allocatedBytes += (long long) size;
+    return block;
+}
+
+ArenaMark markArena() {
+    commandArena.depth++;
+    return (ArenaMark) {commandArena.chunk, commandArena.chunk ? commandArena.chunk->used : 0, commandArena.nbLarge};
+}
+
+void releaseArena(ArenaMark mark) {
+    commandArena.depth--;
+    while (commandArena.nbLarge > mark.nbLarge) poolFree(commandArena.large[--commandArena.nbLarge]);
+    //The first chunk is kept even when the arena was empty at the mark
+    while (commandArena.chunk && commandArena.chunk != mark.chunk && commandArena.chunk->previous) {
+        ArenaChunk *previous = commandArena.chunk->previous;
+        commandArena.size -= commandArena.chunk->capacity;
+        free(commandArena.chunk);
+        commandArena.chunk = previous;
+    }
+    if (commandArena.chunk) commandArena.chunk->used = commandArena.chunk == mark.chunk ? mark.used : 0;
+}
+
+void pauseArena() {
+    commandArena.paused++;
+}
+
+void resumeArena() {
+    commandArena.paused--;
+}
+
+char inArena(const void *block) {
+    return block && (searchChunk(block) || searchLarge(block) >= 0);
+}
+
+void *temporaryMalloc(size_t size) {
+    void *block = ARENA_ENABLED && commandArena.depth > 0 && !commandArena.paused ? arenaAllocate(size) : NULL;
+    return block ? block : poolMalloc(size);
+}
+
+void *temporaryCalloc(size_t number, size_t size) {
+    char *block = ARENA_ENABLED && commandArena.depth > 0 && !commandArena.paused ? arenaAllocate(number * size) : NULL;
+    if (!block) return poolCalloc(number, size);
+    for (size_t i = 0; i < number * size; i++) block[i] = 0;
+    return block;
+}
+
+void *temporaryRealloc(void *block, size_t size) {
+    if (!block) return temporaryMalloc(size);
+    int index = searchLarge(block);
+    if (index >= 0) return commandArena.large[index] = poolRealloc(block, size);
+    ArenaChunk *chunk = searchChunk(block);
+    if (!chunk) return poolRealloc(block, size);
+    ArenaBlock *header = blockHeader(block);
+    if (size <= header->size) return block;
+    //The last block of the last chunk grows in place
+    if (chunk == commandArena.chunk && size < ARENA_LARGE_SIZE && (char *) block + header->size == chunkData(chunk) + chunk->used &&
+        (char *) block + size <= chunkData(chunk) + chunk->capacity) {
+        chunk->used += size - header->size;
+        commandArena.allocatedBytes += (long long) (size - header->size);
+        header->size = (unsigned int) size;
+        return block;
+    }
+    char *moved = temporaryMalloc(size), *old = block;
+    for (size_t i = 0; i < header->size; i++) moved[i] = old[i];
+    return moved;
+}
+
+void temporaryFree(void *block) {
+    if (!block) return;
+    int index = searchLarge(block);
+    if (index >= 0) {
+        poolFree(block);
+        commandArena.nbLarge--;
+        for (int i = index; i < commandArena.nbLarge; i++) commandArena.large[i] = commandArena.large[i + 1];
+        return;
+    }
+    ArenaChunk *chunk = searchChunk(block);
+    if (!chunk) poolFree(block);
+    else if ((char *) block + blockHeader(block)->size == chunkData(chunk) + chunk->used) { //The last block is given back
+        chunk->used = (char *) block - blockHeader(block)->offset - chunkData(chunk);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+/**
+ * @file arena.h Header file of arena.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_ARENA_H
+#define LINEARALGEBRA_ARENA_H
+
+#include "pool.h"
+
+#define ARENA_CHUNK_SIZE (1 << 20) ///Size of the first chunk of the arena, each new chunk is twice as large as the previous one
+#define ARENA_ALIGNMENT POOL_ALIGNMENT ///Alignment of the blocks of the arena, like the blocks of the pool
+#define ARENA_LARGE_SIZE (1 << 18) ///Size from which a block is allocated on its own, it is freed as soon as it isn't used
+#define ARENA_MAX_SIZE (1 << 27) ///Most bytes of the chunks, the temporaries of a longer command are allocated in the pool
+#ifdef TRACK_ALLOCATIONS
+#define ARENA_ENABLED 0 ///The temporaries are allocated in the pool so that the ones a command drops are counted as live
+#else
+#define ARENA_ENABLED 1 ///The temporaries of a command are allocated in the arena
+#endif
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct ArenaChunk
+ * Structure representing a chunk of the arena, its blocks are allocated one after the other
+ */
+typedef struct ArenaChunk {
+    struct ArenaChunk *previous; ///Chunk allocated before this one
+    size_t capacity; ///Number of bytes of the chunk
+    size_t used; ///Number of bytes allocated in the chunk
+} ArenaChunk;
+
+/**
+ * @struct ArenaBlock
+ * Structure representing the header of a block of a chunk, it is just before the aligned values
+ */
+typedef struct {
+    unsigned int size; ///Number of bytes of the block
+    unsigned int offset; ///Number of bytes between the end of the previous block and the block
+} ArenaBlock;
+
+/**
+ * @struct Arena
+ * Structure representing the memory of the temporaries of a command, it is released at once when the command ends
+ */
+typedef struct {
+    ArenaChunk *chunk; ///Last chunk, the new blocks are allocated in it
+    size_t size; ///Number of bytes of the chunks
+    int nbLarge; ///Number of large blocks
+    int capacity; ///Size of the list of large blocks
+    void **large; ///Large blocks in allocation order
+    int depth; ///Number of commands being executed, the temporaries are allocated in the arena while it isn't 0
+    int paused; ///Number of pauses, the allocations are persistent while it isn't 0
+    long long allocatedBytes; ///Bytes of all the blocks allocated in the chunks since the start
+} Arena;
+
+/**
+ * @struct ArenaMark
+ * Structure representing the state of the arena at the start of a command
+ */
+typedef struct {
+    ArenaChunk *chunk; ///Last chunk at the start of the command
+    size_t used; ///Number of bytes allocated in the last chunk
+    int nbLarge; ///Number of large blocks
+} ArenaMark;
+
+extern Arena commandArena; ///Arena of the commands being executed
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Start a command
+ * The temporaries allocated until the mark is released are in the arena
+ * @return state of the arena to restore at the end of the command
+ */
+ArenaMark markArena();
+
+/**
+ * End a command
+ * This function free every temporary allocated since the mark, the chunks created since are given back to the system
+ * except the first one, which is kept for the next commands
+ * @param mark - State of the arena at the start of the command
+ */
+void releaseArena(ArenaMark mark);
+
+/**
+ * Allocate the next blocks in the pool
+ * This function is used for the values kept after the command: registered objects, compiled scripts, calculated
+ * subexpressions. Pauses can be nested
+ */
+void pauseArena();
+
+/**
+ * Allocate the next temporaries in the arena again
+ */
+void resumeArena();
+
+/**
+ * Verify if a block is in the arena
+ * @param block - The block
+ * @return 1 if the block will be freed at the end of the command, 0 if it is in the pool
+ */
+char inArena(const void *block);
+
+/**
+ * Allocate a temporary block
+ * @param size - Number of bytes
+ * @return block in the arena during a command, in the pool otherwise
+ */
+void *temporaryMalloc(size_t size);
+
+/**
+ * Allocate a temporary block filled with zeros
+ * @param number - Number of elements
+ * @param size - Number of bytes of an element
+ * @return block in the arena during a command, in the pool otherwise
+ */
+void *temporaryCalloc(size_t number, size_t size);
+
+/**
+ * Change the size of a block
+ * A block of the arena is grown in place when it is the last one, it is moved otherwise. A block of the pool stays in the pool
+ * @param block - The block, NULL to allocate a new one
+ * @param size - New number of bytes
+ * @return the resized block
+ */
+void *temporaryRealloc(void *block, size_t size);
+
+/**
+ * Free a block
+ * A block of the pool is given back to it, a block of the arena is freed only if it is large or the last one, the others are
+ * freed at the end of the command
+ * @param block - The block
+ */
+void temporaryFree(void *block);
+
+#include "tracking.h"
+
+#endif //LINEARALGEBRA_ARENA_H
\ No newline at end of file
@@ -0,0 +1,398 @@
+/**
+ * @file bench.c Benchmarks of the kernels
+ * @author Valentin Koeltgen
+ *
+ * This file contain the linalg_bench program: it time the matrix and polynomial kernels and the parsing of literals and
+ * scripts over increasing sizes, and write the median and 95th percentile of the samples in JSON. The main function of
+ * main.c isn't built with it, nor the one of this file in linalg_bench_compare
+ */
+
+#include "bench.h"
+#include <stdarg.h>
+
+unsigned long long benchSeed = 1; ///State of the generator of the operands
+volatile double benchSink = 0; ///Results of the kernels returning numbers, so that their calls aren't removed
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Operands
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Next value of the generator of the operands
+ * The values only depend on the seed, so that each run times the same operands
+ * @return value between -1 and 1
+ */
+double nextBenchValue() {
+    benchSeed = benchSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double) (benchSeed >> 11) / (double) (1ULL << 52) - 1;
+}
+
+/**
+ * Matrix of generated values
+ * It is shared like a registered matrix, so that the kernels copy it before changing it
+ * @param rows - Number of rows
+ * @param columns - Number of columns
+ * @return the matrix
+ */
+Matrix benchMatrix(int rows, int columns) {
+    Matrix M = newMatrix(rows, columns);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < columns; j++) M.values[i][j] = nextBenchValue();
+    }
+    return shareMatrix(M);
+}
+
+/**
+ * Dense polynomial of generated coefficients
+ * It is shared like a registered polynomial, so that the kernels copy it before changing it
+ * @param degree - Degree of the polynomial
+ * @return the polynomial
+ */
+Polynomial benchPolynomial(int degree) {
+    Polynomial F = newPolynomial(degree);
+    for (int i = 0; i <= degree; i++) F.coefficient[i] = nextBenchValue();
+    F.coefficient[degree] = 1 + (F.coefficient[degree] + 1) / 2; //Far from 0 for the divisions
+    return sharePolynomial(F);
+}
+
+/**
+ * Add a formatted text at the end of the text of an input
+ * @param input - The input, its text must have room for the formatted text
+ * @param format - Format of the text, like printf
+ * @param ... - Values of the format
+ */
+void appendBenchText(BenchInput *input, const char *format, ...) {
+    va_list values;
+    va_start(values, format);
+    input->textSize += vsprintf(input->text + input->textSize, format, values);
+    va_end(values);
+}
+
+/**
+ * Build a square matrix
+ * @param input - Return the operands
+ * @param size - Number of rows
+ */
+void prepareMatrix(BenchInput *input, int size) {
+    input->matrix = benchMatrix(size, size);
+}
+
+/**
+ * Build the augmented matrix of a system of equations
+ * @param input - Return the operands
+ * @param size - Number of equations
+ */
+void prepareAugmentedMatrix(BenchInput *input, int size) {
+    input->matrix = benchMatrix(size, size + 1);
+}
+
+/**
+ * Build a symmetric matrix, its eigen values are real
+ * @param input - Return the operands
+ * @param size - Number of rows
+ */
+void prepareSymmetricMatrix(BenchInput *input, int size) {
+    input->matrix = benchMatrix(size, size); //Not changed by the kernel yet
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < i; j++) input->matrix.values[i][j] = input->matrix.values[j][i];
+    }
+}
+
+/**
+ * Build 2 dense polynomials
+ * @param input - Return the operands
+ * @param size - Degree of the polynomials
+ */
+void preparePolynomials(BenchInput *input, int size) {
+    input->first = benchPolynomial(size);
+    input->second = benchPolynomial(size);
+}
+
+/**
+ * Build a numerator and a denominator of half its degree
+ * @param input - Return the operands
+ * @param size - Degree of the denominator
+ */
+void prepareDivision(BenchInput *input, int size) {
+    input->first = benchPolynomial(2 * size);
+    input->second = benchPolynomial(size);
+}
+
+/**
+ * Build a polynomial of distinct real roots
+ * @param input - Return the operands
+ * @param size - Degree of the polynomial
+ */
+void prepareRoots(BenchInput *input, int size) {
+    //Product of (X - root) for distinct roots in [-1, 1], all of them are real
+    input->first = newPolynomial(0);
+    input->first.coefficient[0] = 1;
+    for (int i = 0; i < size; i++) {
+        Polynomial factor = newPolynomial(1), product;
+        factor.coefficient[0] = 1 - 2 * (i + 0.5) / size;
+        factor.coefficient[1] = 1;
+        product = pMultiply(input->first, factor);
+        freePolynomial(&input->first); freePolynomial(&factor);
+        input->first = product;
+    }
+    input->first = sharePolynomial(input->first);
+}
+
+/**
+ * Write a matrix literal
+ * @param input - Return the operands
+ * @param size - Number of rows and columns
+ */
+void prepareMatrixLiteral(BenchInput *input, int size) {
+    input->text = malloc((size_t) size * size * 12 + 2);
+    appendBenchText(input, "[");
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) appendBenchText(input, "%.6f%s", nextBenchValue(), j < size - 1 ? "," : i < size - 1 ? ";" : "]");
+    }
+}
+
+/**
+ * Write a polynomial literal
+ * @param input - Return the operands
+ * @param size - Number of terms
+ */
+void preparePolynomialLiteral(BenchInput *input, int size) {
+    input->text = malloc((size_t) size * 24 + 1);
+    for (int i = 0; i < size; i++) appendBenchText(input, "%s%.6fX^%d", i ? " + " : "", nextBenchValue() + 2, i);
+}
+
+/**
+ * Write a script of assignments, products and displays
+ * @param input - Return the operands
+ * @param size - Number of lines
+ */
+void prepareScript(BenchInput *input, int size) {
+    input->text = malloc((size_t) size * 48 + 1);
+    input->copy = malloc((size_t) size * 48 + 1);
+    for (int i = 0; i < size; i++) {
+        if (i % 4 == 0) appendBenchText(input, "A%d = [%d,2,3;4,5,6;7,8,9]\n", i % 64, i);
+        else if (i % 4 == 1) appendBenchText(input, "B = A%d * trans(A%d) + A%d\n", (i - 1) % 64, (i - 1) % 64, (i - 1) % 64);
+        else if (i % 4 == 2) appendBenchText(input, "P%d = 3X^2 - 2.5X + %d\n", i % 64, i);
+        else appendBenchText(input, "display(P%d * P%d - det(B))\n", (i - 1) % 64, (i - 1) % 64);
+    }
+}
+
+/**
+ * Free the operands of a kernel
+ * @param input - The operands
+ */
+void freeBenchInput(BenchInput *input) {
+    if (input->matrix.values) freeMatrix(&input->matrix);
+    if (input->first.coefficient) freePolynomial(&input->first);
+    if (input->second.coefficient) freePolynomial(&input->second);
+    free(input->text); free(input->copy);
+}
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Kernels
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Free solutions
+ * @param x - The solutions, NULL if there are none
+ */
+void freeBenchSolutions(Solutions *x) {
+    if (x) free(x->values);
+    free(x);
+}
+
+/**
+ * Call a kernel once
+ * The results are temporaries of the call, the ones returned as numbers are kept in benchSink
+ * @param input - Operands of the kernel
+ */
+void runMultiply(BenchInput *input) {
+    multiply(input->matrix, input->matrix);
+}
+
+void runTranspose(BenchInput *input) {
+    transpose(input->matrix);
+}
+
+void runDet(BenchInput *input) {
+    benchSink = det(input->matrix);
+}
+
+void runInverse(BenchInput *input) {
+    inverse(input->matrix);
+}
+
+void runSolveAugmentedMatrix(BenchInput *input) {
+    solveAugmentedMatrix(input->matrix);
+}
+
+void runEigenValues(BenchInput *input) {
+    freeBenchSolutions(eigenValues(input->matrix));
+}
+
+void runPMultiply(BenchInput *input) {
+    pMultiply(input->first, input->second);
+}
+
+void runPLongDivide(BenchInput *input) {
+    //The remainder isn't displayed like with pLongDivide, it would be written with the results
+    Polynomial quotient, remainder;
+    pDivideWithRemainder(input->first, input->second, &quotient, &remainder);
+}
+
+void runSolve(BenchInput *input) {
+    freeBenchSolutions(solve(input->first));
+}
+
+void runApply(BenchInput *input) {
+    benchSink = apply(input->first, 0.75);
+}
+
+void runParse(BenchInput *input) {
+    freeNode(parseCommand(input->text, 0));
+}
+
+void runCompileScript(BenchInput *input) {
+    for (int i = 0; i <= input->textSize; i++) input->copy[i] = input->text[i];
+    Program program = compileScript(input->copy, input->textSize);
+    freeProgram(&program);
+}
+
+const BenchKernel benchKernels[] = {
+        {"multiply", {16, 64, 128, 256}, prepareMatrix, runMultiply},
+        {"transpose", {64, 256, 1024, 2048}, prepareMatrix, runTranspose},
+        {"det", {4, 6, 7, 8}, prepareMatrix, runDet},
+        {"inverse", {4, 5, 6, 7}, prepareMatrix, runInverse},
+        {"solveAugmentedMatrix", {16, 64, 128, 256}, prepareAugmentedMatrix, runSolveAugmentedMatrix},
+        {"eigenValues", {2, 3, 4, 5}, prepareSymmetricMatrix, runEigenValues},
+        {"pMultiply", {16, 256, 1024, 4096}, preparePolynomials, runPMultiply},
+        {"pLongDivide", {16, 256, 1024, 4096}, prepareDivision, runPLongDivide},
+        {"solve", {4, 8, 12, 16}, prepareRoots, runSolve},
+        {"apply", {16, 256, 4096, 65536}, preparePolynomials, runApply},
+        {"parseMatrix", {16, 64, 256, 512}, prepareMatrixLiteral, runParse},
+        {"parsePolynomial", {16, 256, 1024, 4096}, preparePolynomialLiteral, runParse},
+        {"compileScript", {16, 256, 1024, 4096}, prepareScript, runCompileScript}
+};
+const int nbBenchKernels = sizeof(benchKernels) / sizeof(BenchKernel);
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Timing
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Time calls of a kernel
+ * Each call is a command: its temporaries are allocated in the arena and freed at once after it
+ * @param kernel - The kernel
+ * @param input - Operands of the kernel
+ * @param iterations - Number of calls
+ * @return seconds of all the calls
+ */
+double timeCalls(BenchKernel kernel, BenchInput *input, int iterations) {
+    double start = wallTime();
+    for (int i = 0; i < iterations; i++) {
+        ArenaMark mark = markArena();
+        kernel.run(input);
+        releaseArena(mark);
+    }
+    return wallTime() - start;
+}
+
+int compareSamples(const void *first, const void *second) {
+    double difference = *(const double *) first - *(const double *) second;
+    return difference < 0 ? -1 : difference > 0;
+}
+
+void measureKernel(BenchKernel kernel, int size, BenchSettings settings, BenchResult *result) {
+    BenchInput input = {nullMatrix, {NULL, NULL, -1, NULL, 0, NULL}, {NULL, NULL, -1, NULL, 0, NULL}, NULL, 0, NULL};
+    benchSeed = (unsigned long long) size;
+    kernel.prepare(&input, size);
+    //The number of calls of a sample doubles until it lasts long enough, the first samples also warm the caches and the pool
+    int iterations = 1;
+    double seconds = 0;
+    for (int run = 0; run < settings.warmup || seconds < BENCH_MIN_SAMPLE_TIME; run++) {
+        if (run && seconds < BENCH_MIN_SAMPLE_TIME) iterations *= 2;
+        seconds = timeCalls(kernel, &input, iterations);
+    }
+    *result = (BenchResult) {kernel.name, size, iterations, settings.repetitions, {0}, 0, 0, 0};
+    for (int i = 0; i < settings.repetitions; i++) {
+        result->samples[i] = timeCalls(kernel, &input, iterations) / iterations;
+        result->mean += result->samples[i] / settings.repetitions;
+    }
+    freeBenchInput(&input);
+    qsort(result->samples, settings.repetitions, sizeof(double), compareSamples);
+    int middle = settings.repetitions / 2;
+    result->median = settings.repetitions % 2 ? result->samples[middle] : (result->samples[middle - 1] + result->samples[middle]) / 2;
+    int rank = (95 * settings.repetitions + 99) / 100; //Nearest rank
+    result->p95 = result->samples[rank - 1];
+}
+
+BenchResult *runBenchmarks(BenchSettings settings, int *nbResults) {
+    BenchResult *results = malloc(nbBenchKernels * BENCH_MAX_SIZES * sizeof(BenchResult));
+    *nbResults = 0;
+    for (int i = 0; i < nbBenchKernels; i++) {
+        if (settings.kernel && shorterString(settings.kernel, benchKernels[i].name)) continue;
+        for (int j = 0; j < (settings.quick ? BENCH_QUICK_SIZES : BENCH_MAX_SIZES) && benchKernels[i].sizes[j]; j++) {
+            BenchResult *result = &results[(*nbResults)++];
+            measureKernel(benchKernels[i], benchKernels[i].sizes[j], settings, result);
+            fprintf(stderr, "%-22s %6d\tmedian %.3e s\tp95 %.3e s\t(%d x %d calls)\n", result->kernel, result->size, result->median,
+                    result->p95, result->repetitions, result->iterations);
+        }
+    }
+    return results;
+}
+
+void writeBenchResults(FILE *output, const BenchResult *results, int nbResults, BenchSettings settings) {
+#ifdef __OPTIMIZE__
+    const char *optimized = "true";
+#else
+    const char *optimized = "false";
+#endif
+    fprintf(output, "{\n  \"version\": %d,\n  \"optimized\": %s,\n  \"repetitions\": %d,\n  \"warmup\": %d,\n  \"results\": [",
+            BENCH_VERSION, optimized, settings.repetitions, settings.warmup);
+    for (int i = 0; i < nbResults; i++) {
+        const BenchResult *result = &results[i];
+        fprintf(output, "%s\n    {\"kernel\": \"%s\", \"size\": %d, \"iterations\": %d, \"median\": %.9g, \"p95\": %.9g, \"mean\": %.9g, \"samples\": [",
+                i ? "," : "", result->kernel, result->size, result->iterations, result->median, result->p95, result->mean);
+        for (int j = 0; j < result->repetitions; j++) fprintf(output, "%s%.9g", j ? ", " : "", result->samples[j]);
+        fprintf(output, "]}");
+    }
+    fprintf(output, "\n  ]\n}\n");
+}
+
+char readBenchSettings(BenchSettings *settings, int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!shorterString(argv[i], "--quick")) settings->quick = 1;
+        else if (!shorterString(argv[i], "--repetitions") && value) settings->repetitions = atoi(argv[++i]);
+        else if (!shorterString(argv[i], "--warmup") && value) settings->warmup = atoi(argv[++i]);
+        else if (!shorterString(argv[i], "--kernel") && value) settings->kernel = argv[++i];
+        else if (!shorterString(argv[i], "--output") && value) settings->output = argv[++i];
+        else return 0;
+    }
+    return settings->repetitions > 0 && settings->repetitions <= BENCH_MAX_REPETITIONS && settings->warmup >= 0;
+}
+
+#ifndef LINEARALGEBRA_NO_BENCH_MAIN
+/**
+ * Main function of linalg_bench
+ * @param argc - Number of arguments
+ * @param argv - Arguments: --quick, --repetitions <n>, --warmup <n>, --kernel <name>, --output <link>
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if the options are invalid or the results can't be written
+ */
+int main(int argc, char **argv) {
+    BenchSettings settings = {BENCH_REPETITIONS, BENCH_WARMUP, 0, NULL, NULL};
+    if (!readBenchSettings(&settings, argc, argv)) {
+        fprintf(stderr, "Usage: %s [--quick] [--repetitions <1-%d>] [--warmup <n>] [--kernel <name>] [--output <link>]\n", argv[0], BENCH_MAX_REPETITIONS);
+        return EXIT_FAILURE;
+    }
+    int nbResults;
+    BenchResult *results = runBenchmarks(settings, &nbResults);
+    FILE *output = settings.output ? fopen(settings.output, "w") : stdout;
+    if (!output) {
+        fprintf(stderr, "Couldn't write the results in %s\n", settings.output);
+        free(results);
+        return EXIT_FAILURE;
+    }
+    writeBenchResults(output, results, nbResults, settings);
+    if (output != stdout) fclose(output);
+    free(results);
+    return EXIT_SUCCESS;
+}
+#endif
\ No newline at end of file
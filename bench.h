@@ -0,0 +1,125 @@
+/**
+ * @file bench.h Header file of bench.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_BENCH_H
+#define LINEARALGEBRA_BENCH_H
+
+#include "main.h"
+
+#define BENCH_VERSION 1 ///Version of the JSON results, to change with their fields
+#define BENCH_MAX_SIZES 4 ///Most sizes swept for a kernel
+#define BENCH_QUICK_SIZES 2 ///Number of sizes swept in a quick run, the smallest ones
+#define BENCH_REPETITIONS 15 ///Default number of timed samples of each size
+#define BENCH_WARMUP 3 ///Default number of untimed samples run before, they also find the number of calls of a sample
+#define BENCH_MIN_SAMPLE_TIME 2e-3 ///Fewest seconds of a sample, fast kernels are called several times per sample
+#define BENCH_MAX_REPETITIONS 1000 ///Most timed samples of each size
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct BenchInput
+ * Structure representing the operands of a kernel for a size, they are built before the timing
+ */
+typedef struct {
+    Matrix matrix; ///Matrix operand
+    Polynomial first; ///First polynomial operand
+    Polynomial second; ///Second polynomial operand
+    char *text; ///Literal or script to parse
+    int textSize; ///Number of characters of the text
+    char *copy; ///Copy of the text, a script is cut in place by its compilation
+} BenchInput;
+
+/**
+ * @struct BenchKernel
+ * Structure representing a benchmarked kernel
+ */
+typedef struct {
+    const char *name; ///Name of the kernel in the results
+    int sizes[BENCH_MAX_SIZES]; ///Swept sizes in increasing order, 0 after the last one
+    void (*prepare)(BenchInput *input, int size); ///Build the operands of a size
+    void (*run)(BenchInput *input); ///Call the kernel once, its temporaries are freed after it
+} BenchKernel;
+
+/**
+ * @struct BenchSettings
+ * Structure representing the options of a run
+ */
+typedef struct {
+    int repetitions; ///Number of timed samples of each size
+    int warmup; ///Number of untimed samples of each size
+    char quick; ///1 to only sweep the smallest sizes
+    const char *kernel; ///Only kernel run, NULL to run them all
+    const char *output; ///Link of the JSON results, NULL to write them on the standard output
+} BenchSettings;
+
+/**
+ * @struct BenchResult
+ * Structure representing the timing of a kernel for a size
+ */
+typedef struct {
+    const char *kernel; ///Name of the kernel
+    int size; ///Size of the operands
+    int iterations; ///Number of calls of each sample
+    int repetitions; ///Number of samples
+    double samples[BENCH_MAX_REPETITIONS]; ///Seconds per call of each sample, in increasing order
+    double median; ///Median of the samples
+    double p95; ///95th percentile of the samples
+    double mean; ///Mean of the samples
+} BenchResult;
+
+extern const BenchKernel benchKernels[]; ///Benchmarked kernels
+extern const int nbBenchKernels; ///Number of benchmarked kernels
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Read the options of a run
+ * @param settings - Return the options, the unspecified ones keep their default value
+ * @param argc - Number of arguments of the program
+ * @param argv - Arguments of the program
+ * @return 1 if the options are valid, 0 otherwise
+ */
+char readBenchSettings(BenchSettings *settings, int argc, char **argv);
+
+/**
+ * Compare 2 samples for qsort
+ * @param first - First sample
+ * @param second - Second sample
+ * @return negative, null or positive if the first sample is lower, equal or greater
+ */
+int compareSamples(const void *first, const void *second);
+
+/**
+ * Time a kernel for a size
+ * The samples are timed after the warmup, each of them calls the kernel enough times to last BENCH_MIN_SAMPLE_TIME
+ * @param kernel - The kernel
+ * @param size - Size of the operands
+ * @param settings - Options of the run
+ * @param result - Return the timing
+ */
+void measureKernel(BenchKernel kernel, int size, BenchSettings settings, BenchResult *result);
+
+/**
+ * Time the kernels
+ * This function time each kernel (or the one chosen by the options) for each of its sizes, the progress is displayed
+ * on the error output
+ * @param settings - Options of the run
+ * @param nbResults - Return the number of timings
+ * @return timing of each kernel and size, in the order of benchKernels
+ */
+BenchResult *runBenchmarks(BenchSettings settings, int *nbResults);
+
+/**
+ * Write timings in JSON
+ * @param output - File of the results
+ * @param results - The timings
+ * @param nbResults - Number of timings
+ * @param settings - Options of the run
+ */
+void writeBenchResults(FILE *output, const BenchResult *results, int nbResults, BenchSettings settings);
+
+#endif //LINEARALGEBRA_BENCH_H
\ No newline at end of file
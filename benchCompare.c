@@ -0,0 +1,358 @@
+/**
+ * @file benchCompare.c Comparison of the benchmarks to a baseline
+ * @author Valentin Koeltgen
+ *
+ * This file contain the linalg_bench_compare program: it read timings stored by linalg_bench, time again the same
+ * kernels and sizes, and fail when the median of one of them is slower than a threshold and the Mann-Whitney test of the
+ * samples says the slowdown isn't noise. The main functions of main.c and bench.c aren't built with it
+ */
+
+#include "benchCompare.h"
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Reading of the baseline
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Skip the spaces of a JSON text
+ * @param text - The text
+ * @return first character after the spaces
+ */
+const char *skipJsonSpaces(const char *text) {
+    while (*text == ' ' || *text == '\n' || *text == '\r' || *text == '\t') text++;
+    return text;
+}
+
+/**
+ * Read a JSON string
+ * The escaped characters aren't decoded, the names written by linalg_bench don't have any
+ * @param text - The text, on the opening quote
+ * @param string - Return the string, cut after size - 1 characters
+ * @param size - Size of the string
+ * @return first character after the closing quote, NULL if the text isn't a string
+ */
+const char *readJsonString(const char *text, char *string, int size) {
+    if (*text != '"') return NULL;
+    int length = 0;
+    for (text++; *text && *text != '"'; text++) {
+        if (*text == '\\' && text[1]) text++;
+        if (length < size - 1) string[length++] = *text;
+    }
+    string[length] = '\0';
+    return *text ? text + 1 : NULL;
+}
+
+/**
+ * Skip a JSON value
+ * @param text - The text, on the value
+ * @return first character after the value, NULL if it isn't ended
+ */
+const char *skipJsonValue(const char *text) {
+    int depth = 0;
+    char string[2];
+    while (*text && (depth || (*text != ',' && *text != '}' && *text != ']'))) {
+        if (*text == '"') {
+            if (!(text = readJsonString(text, string, 2))) return NULL;
+            continue;
+        }
+        if (*text == '[' || *text == '{') depth++;
+        else if (*text == ']' || *text == '}') depth--;
+        text++;
+    }
+    return *text ? text : NULL;
+}
+
+/**
+ * Read the key of a JSON member
+ * @param text - The text, before the key
+ * @param key - Return the key, of BENCH_KEY_SIZE characters
+ * @return first character of the value, NULL if there is no key
+ */
+const char *readJsonKey(const char *text, char *key) {
+    text = readJsonString(skipJsonSpaces(text), key, BENCH_KEY_SIZE);
+    if (!text || *(text = skipJsonSpaces(text)) != ':') return NULL;
+    return skipJsonSpaces(text + 1);
+}
+
+/**
+ * Read a JSON number
+ * @param text - The text, on the number
+ * @param value - Return the number
+ * @return first character after the number, NULL if it isn't a number
+ */
+const char *readJsonNumber(const char *text, double *value) {
+    char *end;
+    *value = strtod(text, &end);
+    return end != text ? end : NULL;
+}
+
+/**
+ * Go to the next member or element of a JSON object or array
+ * @param text - The text, after a member or an element
+ * @param end - Closing character of the object or array
+ * @return first character of the next member or element, the closing character if it was the last one, NULL otherwise
+ */
+const char *nextJsonItem(const char *text, char end) {
+    if (!text) return NULL;
+    text = skipJsonSpaces(text);
+    if (*text == ',') return skipJsonSpaces(text + 1);
+    return *text == end ? text : NULL;
+}
+
+/**
+ * Read the timing of a kernel for a size
+ * @param text - The text, on the opening brace
+ * @param result - Return the timing, its kernel is NULL if the kernel doesn't exist anymore
+ * @return first character after the closing brace, NULL if the timing isn't valid
+ */
+const char *readBenchResult(const char *text, BenchResult *result) {
+    char key[BENCH_KEY_SIZE], name[BENCH_KEY_SIZE] = "";
+    double value;
+    *result = (BenchResult) {NULL, 0, 0, 0, {0}, 0, 0, 0};
+    if (*text != '{') return NULL;
+    text = skipJsonSpaces(text + 1);
+    while (text && *text != '}') {
+        if (!(text = readJsonKey(text, key))) return NULL;
+        if (!shorterString(key, "kernel")) text = readJsonString(text, name, BENCH_KEY_SIZE);
+        else if (!shorterString(key, "samples")) {
+            if (*text != '[') return NULL;
+            text = skipJsonSpaces(text + 1);
+            while (text && *text != ']') {
+                if (result->repetitions == BENCH_MAX_REPETITIONS || !(text = readJsonNumber(text, &value))) return NULL;
+                result->samples[result->repetitions++] = value;
+                text = nextJsonItem(text, ']');
+            }
+            if (text) text++;
+        } else if (!(text = readJsonNumber(text, &value))) return NULL;
+        else if (!shorterString(key, "size")) result->size = (int) value;
+        else if (!shorterString(key, "iterations")) result->iterations = (int) value;
+        else if (!shorterString(key, "median")) result->median = value;
+        else if (!shorterString(key, "p95")) result->p95 = value;
+        else if (!shorterString(key, "mean")) result->mean = value;
+        text = nextJsonItem(text, '}');
+    }
+    if (!text || !result->repetitions || result->size <= 0) return NULL;
+    qsort(result->samples, result->repetitions, sizeof(double), compareSamples);
+    for (int i = 0; i < nbBenchKernels; i++) {
+        if (!shorterString(name, benchKernels[i].name)) result->kernel = benchKernels[i].name;
+    }
+    if (!result->kernel) fprintf(stderr, "The kernel %s of the baseline doesn't exist anymore, it is skipped\n", name);
+    return text + 1;
+}
+
+Baseline readBaseline(const char *link) {
+    Baseline baseline = {{BENCH_REPETITIONS, BENCH_WARMUP, 0, NULL, NULL}, 0, NULL, 0};
+    int size;
+    char *content = readFileContent(link, &size), key[BENCH_KEY_SIZE];
+    if (!content) return baseline;
+    const char *text = skipJsonSpaces(content);
+    double value, version = 0;
+    text = *text == '{' ? skipJsonSpaces(text + 1) : NULL;
+    while (text && *text != '}') {
+        if (!(text = readJsonKey(text, key))) break;
+        if (!shorterString(key, "results") && *text == '[') {
+            baseline.results = malloc(nbBenchKernels * BENCH_MAX_SIZES * sizeof(BenchResult));
+            text = skipJsonSpaces(text + 1);
+            while (text && *text != ']') {
+                if (baseline.nbResults == nbBenchKernels * BENCH_MAX_SIZES) text = NULL;
+                else if ((text = readBenchResult(text, &baseline.results[baseline.nbResults])) && baseline.results[baseline.nbResults].kernel) {
+                    baseline.nbResults++;
+                }
+                text = nextJsonItem(text, ']');
+            }
+            if (text) text++;
+        } else if (!shorterString(key, "optimized")) {
+            baseline.optimized = *text == 't';
+            text = skipJsonValue(text);
+        } else if ((*text >= '0' && *text <= '9') || *text == '-') {
+            text = readJsonNumber(text, &value);
+            if (!shorterString(key, "version")) version = value;
+            else if (!shorterString(key, "repetitions")) baseline.settings.repetitions = (int) value;
+            else if (!shorterString(key, "warmup")) baseline.settings.warmup = (int) value;
+        } else text = skipJsonValue(text);
+        text = nextJsonItem(text, '}');
+    }
+    free(content);
+    if (!text || (int) version != BENCH_VERSION) {
+        free(baseline.results);
+        baseline.results = NULL;
+        baseline.nbResults = 0;
+    }
+    return baseline;
+}
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Comparison
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+double mannWhitney(const double *baseline, int nbBaseline, const double *current, int nbCurrent) {
+    //Both samples are sorted, they are merged to rank them, equal samples share the mean of their ranks
+    double rankSum = 0, ties = 0;
+    int i = 0, j = 0, n = nbBaseline + nbCurrent;
+    while (i < nbBaseline || j < nbCurrent) {
+        double value = j == nbCurrent || (i < nbBaseline && baseline[i] < current[j]) ? baseline[i] : current[j];
+        int equalBaseline = 0, equalCurrent = 0;
+        while (i < nbBaseline && baseline[i] == value) i++, equalBaseline++;
+        while (j < nbCurrent && current[j] == value) j++, equalCurrent++;
+        double equal = equalBaseline + equalCurrent;
+        rankSum += equalCurrent * (i + j - (equal - 1) / 2);
+        ties += equal * equal * equal - equal;
+    }
+    double u = rankSum - (double) nbCurrent * (nbCurrent + 1) / 2, mean = (double) nbBaseline * nbCurrent / 2;
+    double variance = (double) nbBaseline * nbCurrent / 12 * (n + 1 - ties / ((double) n * (n - 1)));
+    if (variance <= 0) return 0;
+    //Continuity correction of the normal approximation
+    double difference = u - mean;
+    difference = difference > 0.5 ? difference - 0.5 : difference < -0.5 ? difference + 0.5 : 0;
+    return difference / sqrt(variance);
+}
+
+/**
+ * Difference between the median of a baseline and of a current timing
+ * @param before - Timing of the baseline
+ * @param after - Current timing
+ * @return slowdown of the median in percents, negative if it got faster
+ */
+double medianDelta(const BenchResult *before, const BenchResult *after) {
+    return before->median > 0 ? (after->median / before->median - 1) * 100 : 0;
+}
+
+/**
+ * Test whether a kernel regressed
+ * @param before - Timing of the baseline
+ * @param after - Current timing
+ * @param settings - Options of the comparison
+ * @return 1 if the median is slower than the threshold and the z-score is significant, 0 otherwise
+ */
+char regressed(const BenchResult *before, const BenchResult *after, CompareSettings settings) {
+    return medianDelta(before, after) > settings.threshold &&
+           mannWhitney(before->samples, before->repetitions, after->samples, after->repetitions) >= settings.significance;
+}
+
+int compareBenchResults(Baseline baseline, const BenchResult *current, int nbCurrent, CompareSettings settings) {
+    int regressions = 0;
+    writeFormat("%-22s %6s  %-11s  %-11s  %8s  %7s\n", "Kernel", "Size", "Baseline", "Current", "Delta", "z-score");
+    for (int i = 0; i < nbCurrent; i++) {
+        const BenchResult *before = NULL, *after = &current[i];
+        for (int j = 0; j < baseline.nbResults && !before; j++) {
+            if (baseline.results[j].kernel == after->kernel && baseline.results[j].size == after->size) before = &baseline.results[j];
+        }
+        if (!before) continue;
+        double delta = medianDelta(before, after), z = mannWhitney(before->samples, before->repetitions, after->samples, after->repetitions);
+        const char *status = "";
+        if (regressed(before, after, settings)) {
+            status = "\tregression";
+            regressions++;
+        } else if (delta < -settings.threshold && z <= -settings.significance) status = "\tfaster";
+        writeFormat("%-22s %6d  %.3e s  %.3e s  %+7.1f%%  %7.2f%s\n", after->kernel, after->size, before->median, after->median,
+                    delta, z, status);
+    }
+    if (regressions) writeFormat("%d regression%s past %g%%\n", regressions, regressions > 1 ? "s" : "", settings.threshold);
+    else writeFormat("No regression past %g%%\n", settings.threshold);
+    return regressions;
+}
+
+/**
+ * Time again the kernels and sizes of a baseline
+ * A kernel which regressed is timed again up to BENCH_CONFIRMATIONS times and its fastest timing is kept, so that a
+ * short slowdown of the machine doesn't fail the comparison
+ * @param baseline - Stored timings
+ * @param settings - Options of the run
+ * @param compareSettings - Options of the comparison
+ * @return timing of each kernel and size of the baseline, in the same order
+ */
+BenchResult *rerunBaseline(Baseline baseline, BenchSettings settings, CompareSettings compareSettings) {
+    BenchResult *results = malloc((baseline.nbResults ? baseline.nbResults : 1) * sizeof(BenchResult));
+    for (int i = 0; i < baseline.nbResults; i++) {
+        const BenchKernel *kernel = NULL;
+        for (int j = 0; j < nbBenchKernels && !kernel; j++) {
+            if (benchKernels[j].name == baseline.results[i].kernel) kernel = &benchKernels[j];
+        }
+        measureKernel(*kernel, baseline.results[i].size, settings, &results[i]);
+        for (int j = 0; j < BENCH_CONFIRMATIONS && regressed(&baseline.results[i], &results[i], compareSettings); j++) {
+            BenchResult *confirmation = malloc(sizeof(BenchResult));
+            measureKernel(*kernel, baseline.results[i].size, settings, confirmation);
+            if (confirmation->median < results[i].median) results[i] = *confirmation;
+            free(confirmation);
+        }
+        fprintf(stderr, "%-22s %6d\tmedian %.3e s\tp95 %.3e s\t(%d x %d calls)\n", results[i].kernel, results[i].size,
+                results[i].median, results[i].p95, results[i].repetitions, results[i].iterations);
+    }
+    return results;
+}
+
+/**
+ * Read the options of a comparison
+ * The options of linalg_bench changing how the kernels are timed are also read, they default to the ones of the baseline
+ * @param settings - Return the options of the comparison
+ * @param benchSettings - Return the options of the run
+ * @param argc - Number of arguments of the program
+ * @param argv - Arguments of the program
+ * @return 1 if the options are valid, 0 otherwise
+ */
+char readCompareSettings(CompareSettings *settings, BenchSettings *benchSettings, int argc, char **argv) {
+    char **benchArguments = malloc(argc * sizeof(char *));
+    int nbBenchArguments = 1;
+    benchArguments[0] = argv[0];
+    for (int i = 1; i < argc; i++) {
+        char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!shorterString(argv[i], "--threshold") && value) settings->threshold = strtod(argv[++i], NULL);
+        else if (!shorterString(argv[i], "--significance") && value) settings->significance = strtod(argv[++i], NULL);
+        else if (argv[i][0] != '-' && !settings->baseline) settings->baseline = argv[i];
+        else benchArguments[nbBenchArguments++] = argv[i];
+    }
+    char valid = settings->baseline && settings->threshold >= 0 && settings->significance >= 0 &&
+                 readBenchSettings(benchSettings, nbBenchArguments, benchArguments) && !benchSettings->quick && !benchSettings->kernel;
+    free(benchArguments);
+    return valid;
+}
+
+/**
+ * Main function of linalg_bench_compare
+ * @param argc - Number of arguments
+ * @param argv - Arguments: the link of the baseline, --threshold <percents>, --significance <z-score>,
+ * --repetitions <n>, --warmup <n>, --output <link>
+ * @return EXIT_SUCCESS, BENCH_SKIPPED if the baseline file doesn't exist, or EXIT_FAILURE if a kernel regressed, the
+ * options are invalid or the baseline can't be read
+ */
+int main(int argc, char **argv) {
+    CompareSettings settings = {NULL, BENCH_THRESHOLD, BENCH_SIGNIFICANCE};
+    BenchSettings benchSettings = {BENCH_REPETITIONS, BENCH_WARMUP, 0, NULL, NULL};
+    if (!readCompareSettings(&settings, &benchSettings, argc, argv)) {
+        fprintf(stderr, "Usage: %s <baseline> [--threshold <percents>] [--significance <z-score>] [--repetitions <1-%d>] "
+                        "[--warmup <n>] [--output <link>]\n", argv[0], BENCH_MAX_REPETITIONS);
+        return EXIT_FAILURE;
+    }
+    FILE *baselineFile = fopen(settings.baseline, "r");
+    if (!baselineFile) {
+        fprintf(stderr, "There is no baseline %s, record one with linalg_bench --output %s\n", settings.baseline, settings.baseline);
+        return BENCH_SKIPPED;
+    }
+    fclose(baselineFile);
+    Baseline baseline = readBaseline(settings.baseline);
+    if (!baseline.results) {
+        fprintf(stderr, "Couldn't read the baseline %s, it must be written by linalg_bench version %d\n", settings.baseline, BENCH_VERSION);
+        return EXIT_FAILURE;
+    }
+    //The options are read again over the ones of the baseline, so that the kernels are timed the same way by default
+    benchSettings = baseline.settings;
+    settings.baseline = NULL;
+    readCompareSettings(&settings, &benchSettings, argc, argv);
+#ifdef __OPTIMIZE__
+    char optimized = 1;
+#else
+    char optimized = 0;
+#endif
+    if (optimized != baseline.optimized) {
+        fprintf(stderr, "The baseline was timed by %s build, the timings can't be compared fairly\n", baseline.optimized ? "an optimized" : "a debug");
+    }
+    BenchResult *results = rerunBaseline(baseline, benchSettings, settings);
+    int regressions = compareBenchResults(baseline, results, baseline.nbResults, settings);
+    flushOutput();
+    FILE *output = benchSettings.output ? fopen(benchSettings.output, "w") : NULL;
+    if (output) {
+        writeBenchResults(output, results, baseline.nbResults, benchSettings);
+        fclose(output);
+    } else if (benchSettings.output) fprintf(stderr, "Couldn't write the results in %s\n", benchSettings.output);
+    free(results);
+    free(baseline.results);
+    return regressions ? EXIT_FAILURE : EXIT_SUCCESS;
+}
\ No newline at end of file
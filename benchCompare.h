@@ -0,0 +1,75 @@
+/**
+ * @file benchCompare.h Header file of benchCompare.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_BENCHCOMPARE_H
+#define LINEARALGEBRA_BENCHCOMPARE_H
+
+#include "bench.h"
+
+#define BENCH_THRESHOLD 10 ///Default slowdown of the median in percents past which a kernel regressed
+#define BENCH_SIGNIFICANCE 2.326 ///Default least z-score of the Mann-Whitney test, 2.326 is a one-sided 1% level
+#define BENCH_CONFIRMATIONS 2 ///Most times a regressed kernel is timed again before it fails the comparison
+#define BENCH_KEY_SIZE 32 ///Most characters of a key of the JSON results
+#define BENCH_SKIPPED 77 ///Exit code of a comparison without baseline file, ctest reports the test as skipped
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct Baseline
+ * Structure representing stored timings
+ */
+typedef struct {
+    BenchSettings settings; ///Options of the run of the timings
+    char optimized; ///1 if the timings were made by an optimized build
+    BenchResult *results; ///The timings, NULL if they couldn't be read
+    int nbResults; ///Number of timings
+} Baseline;
+
+/**
+ * @struct CompareSettings
+ * Structure representing the options of a comparison
+ */
+typedef struct {
+    const char *baseline; ///Link of the stored timings
+    double threshold; ///Slowdown of the median in percents past which a kernel regressed
+    double significance; ///Least z-score of the Mann-Whitney test for a difference not to be noise
+} CompareSettings;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Read timings written by linalg_bench
+ * The timings of the kernels which don't exist anymore are skipped
+ * @param link - Link of the JSON results
+ * @return the timings, their results are NULL if the file can't be read or isn't in the format of BENCH_VERSION
+ */
+Baseline readBaseline(const char *link);
+
+/**
+ * Mann-Whitney test of a slowdown
+ * This function rank the samples together, the z-score is positive when the current samples tend to be the slowest
+ * @param baseline - Samples of the baseline
+ * @param nbBaseline - Number of samples of the baseline
+ * @param current - Samples of the current run
+ * @param nbCurrent - Number of samples of the current run
+ * @return z-score of the rank sum of the current samples, 0 if all the samples are equal
+ */
+double mannWhitney(const double *baseline, int nbBaseline, const double *current, int nbCurrent);
+
+/**
+ * Compare timings to a baseline
+ * This function display the median of the baseline and of the current run, their difference and the z-score of each
+ * kernel and size timed in both
+ * @param baseline - Stored timings
+ * @param current - Timings of the current run
+ * @param nbCurrent - Number of timings of the current run
+ * @param settings - Options of the comparison
+ * @return number of kernels and sizes slower than the threshold with a significant z-score
+ */
+int compareBenchResults(Baseline baseline, const BenchResult *current, int nbCurrent, CompareSettings settings);
+
+#endif //LINEARALGEBRA_BENCHCOMPARE_H
\ No newline at end of file
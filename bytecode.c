@@ -0,0 +1,502 @@
+/**
+ * @file bytecode.c Functions on compiled scripts
+ * @author Valentin Koeltgen
+ *
+ * This file contain the compiler turning a script into instructions for a stack machine, the stack machine running them
+ * and the cache keeping the compiled form of a script next to it
+ */
+
+#include "main.h"
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Construction functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Add an instruction to a program
+ * The list of instructions is doubled every time it is full
+ * @param program - The program to complete
+ * @param instruction - The instruction to add
+ */
+void addInstruction(Program *program, Instruction instruction) {
+    if (!(program->size & (program->size - 1))) { //Size is 0 or a power of 2, the list is full
+        program->instructions = realloc(program->instructions, (program->size ? 2 * program->size : 1) * sizeof(Instruction));
+    }
+    program->instructions[program->size++] = instruction;
+}
+
+/**
+ * Slot of a name
+ * This function return the slot of a name in a program, the slot is created if the name wasn't used before
+ * @param program - The program using the name
+ * @param name - The name
+ * @return slot of the name
+ */
+int slotOf(Program *program, const char *name) {
+    for (int i = 0; i < program->nbNames; i++) if (!shorterString(program->names[i], name)) return i;
+    program->names = realloc(program->names, (program->nbNames + 1) * sizeof(char *));
+    program->names[program->nbNames] = extractUpToIndex(name, length(name));
+    return program->nbNames++;
+}
+
+/**
+ * Keep a command in a program
+ * @param program - The program
+ * @param command - The command to keep
+ * @return index of the command in the program
+ */
+int addCommand(Program *program, const char *command) {
+    program->commands = realloc(program->commands, (program->nbCommands + 1) * sizeof(char *));
+    program->commands[program->nbCommands] = extractUpToIndex(command, length(command));
+    return program->nbCommands++;
+}
+
+/**
+ * Keep a matrix literal in a program
+ * @param program - The program
+ * @param M - Values of the literal, they are moved in the program
+ * @return index of the matrix in the program
+ */
+int addMatrix(Program *program, Matrix M) {
+    program->matrices = realloc(program->matrices, (program->nbMatrices + 1) * sizeof(Matrix));
+    program->matrices[program->nbMatrices] = promoteMatrix(M);
+    return program->nbMatrices++;
+}
+
+/**
+ * Compile a syntax tree
+ * This function add the instructions leaving the result of a tree on top of the stack
+ * @param program - The program to complete
+ * @param node - The tree to compile
+ * @param depth - Number of objects on the stack before the instructions of the tree
+ * @return 1 if the tree was compiled, 0 if it contain something the stack machine can't run
+ */
+char compileNode(Program *program, Node *node, int depth) {
+    if (depth + 1 > program->maxStack) program->maxStack = depth + 1;
+    Instruction instruction = {0, 0, 0, 0, 0};
+    if (node->type == NODE_NUMBER) {
+        instruction.opcode = OP_NUMBER; instruction.value = node->value;
+    } else if (node->type == NODE_TERM) {
+        instruction.opcode = OP_TERM; instruction.value = node->value; instruction.first = node->power;
+    } else if (node->type == NODE_NAME) {
+        instruction.opcode = OP_LOAD; instruction.first = slotOf(program, node->name);
+    } else if (node->type == NODE_MATRIX && node->matrix.values) {
+        instruction.opcode = OP_CONSTANT; instruction.first = addMatrix(program, node->matrix);
+        node->matrix = nullMatrix;
+    } else if (node->type == NODE_CALL && isRememberedCall(node)) {
+        //The call is skipped when its subexpression is already calculated, it is remembered otherwise
+        char *key = subexpressionKey(node);
+        int keyIndex = addCommand(program, key), find = program->size;
+        free(key);
+        addInstruction(program, (Instruction) {OP_FIND, 0, keyIndex, 0, 0});
+        for (int i = 0; i < node->nbChildren; i++) if (!compileNode(program, node->children[i], depth + i)) return 0;
+        addInstruction(program, (Instruction) {OP_CALL, 0, node->function, node->nbChildren, 0});
+        instruction.opcode = OP_REMEMBER; instruction.first = keyIndex;
+        addInstruction(program, instruction);
+        program->instructions[find].second = program->size;
+        return 1;
+    } else if (node->type == NODE_NEGATE || node->type == NODE_OPERATION || node->type == NODE_MATRIX ||
+               (node->type == NODE_CALL && node->function >= NB_FINAL_FUNCTIONS)) {
+        //Children are pushed in order, then combined
+        for (int i = 0; i < node->nbChildren; i++) if (!compileNode(program, node->children[i], depth + i)) return 0;
+        if (node->type == NODE_NEGATE) instruction.opcode = OP_NEGATE;
+        else if (node->type == NODE_OPERATION) {
+            instruction.opcode = OP_OPERATION; instruction.operator = node->operator;
+        } else if (node->type == NODE_MATRIX) {
+            instruction.opcode = OP_MATRIX; instruction.first = node->rows; instruction.second = node->columns;
+        } else {
+            instruction.opcode = OP_CALL; instruction.first = node->function; instruction.second = node->nbChildren;
+        }
+    } else return 0;
+    addInstruction(program, instruction);
+    return 1;
+}
+
+/**
+ * Compile a line of a script
+ * @param program - The program to complete
+ * @param line - The line to compile
+ */
+void compileLine(Program *program, const char *line) {
+    int start = program->size, firstMatrix = program->nbMatrices;
+    Node *root = isSimpleCommand(line) ? NULL : parseCommand(line, 0);
+    char compiled = 0;
+    if (root && root->type == NODE_CALL && root->function < NB_FINAL_FUNCTIONS) { //Final commands
+        if (root->nbChildren == 1 && compileNode(program, root->children[0], 0)) {
+            addInstruction(program, (Instruction) {OP_FINAL, 0, root->function, addCommand(program, line), 0});
+            compiled = 1;
+        }
+    } else if (root && root->type == NODE_ASSIGNMENT) {
+        if (compileNode(program, root->children[0], 0)) {
+            addInstruction(program, (Instruction) {OP_STORE, 0, slotOf(program, root->name), 0, 0});
+            compiled = 1;
+        }
+    } else if (root && compileNode(program, root, 0)) {
+        addInstruction(program, (Instruction) {OP_DISCARD, 0, 0, 0, 0});
+        compiled = 1;
+    }
+    if (!compiled) { //Simple commands and invalid lines are applied as they are when running
+        program->size = start;
+        while (program->nbMatrices > firstMatrix) freeMatrix(&program->matrices[--program->nbMatrices]);
+        addInstruction(program, (Instruction) {OP_COMMAND, 0, addCommand(program, line), 0, 0});
+    }
+    freeNode(root);
+}
+
+Program compileScript(char *script, int size) {
+    Program program = {0, NULL, 0, NULL, 0, NULL, 0, 0, NULL};
+    //Lines are cut in the script like the commands read by the interpreter
+    char *line;
+    for (int start = 0; (line = cutCommand(script, &start, size, 1));) {
+        ArenaMark mark = markArena(); //The syntax tree of a line is freed once compiled
+        compileLine(&program, line);
+        releaseArena(mark);
+    }
+    return program;
+}
+
+char *readFileContent(const char *link, int *size) {
+    FILE *input = fopen(link, "rb");
+    if (!input) return NULL;
+    fseek(input, 0, SEEK_END);
+    *size = (int) ftell(input);
+    fseek(input, 0, SEEK_SET);
+    char *content = malloc((*size + 1) * sizeof(char));
+    *size = (int) fread(content, sizeof(char), *size, input);
+    content[*size] = '\0';
+    fclose(input);
+    return content;
+}
+
+Program loadScript(const char *link) {
+    int size;
+    char *script = readFileContent(link, &size);
+    if (!script) return (Program) {-1};
+    unsigned long long hash = hashContent(script, size);
+    int linkSize = length(link) + length(BYTECODE_EXTENSION) + 1;
+    char *compiledLink = malloc(linkSize * sizeof(char));
+    snprintf(compiledLink, linkSize * sizeof(char), "%s%s", link, BYTECODE_EXTENSION);
+    Program program = readProgram(compiledLink, hash);
+    if (program.size < 0) { //No compiled form for this content, compile it and save it for the next time
+        program = compileScript(script, size);
+        saveProgram(program, hash, compiledLink);
+    }
+    free(compiledLink);
+    free(script);
+    return program;
+}
+
+void freeProgram(Program *program) {
+    for (int i = 0; i < program->nbNames; i++) free(program->names[i]);
+    for (int i = 0; i < program->nbCommands; i++) free(program->commands[i]);
+    for (int i = 0; i < program->nbMatrices; i++) freeMatrix(&program->matrices[i]);
+    free(program->instructions); free(program->names); free(program->commands); free(program->matrices);
+    *program = (Program) {-1};
+}
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Save a list of strings
+ * Each string is saved as its length followed by its characters
+ * @param output - The file to write in
+ * @param strings - The strings to save
+ * @param size - Number of strings
+ */
+void saveStrings(FILE *output, char **strings, int size) {
+    for (int i = 0; i < size; i++) {
+        int stringLength = length(strings[i]);
+        fwrite(&stringLength, sizeof(int), 1, output);
+        fwrite(strings[i], sizeof(char), stringLength, output);
+    }
+}
+
+/**
+ * Save a list of matrices
+ * Each matrix is saved as its number of rows and columns followed by its values row by row
+ * @param output - The file to write in
+ * @param matrices - The matrices to save
+ * @param size - Number of matrices
+ */
+void saveMatrices(FILE *output, Matrix *matrices, int size) {
+    for (int i = 0; i < size; i++) {
+        fwrite(&matrices[i].rows, sizeof(int), 1, output);
+        fwrite(&matrices[i].columns, sizeof(int), 1, output);
+        for (int j = 0; j < matrices[i].rows; j++) fwrite(matrices[i].values[j], sizeof(double), matrices[i].columns, output);
+    }
+}
+
+char saveProgram(Program program, unsigned long long hash, const char *link) {
+    FILE *output = fopen(link, "wb");
+    if (!output) return 0;
+    int version = BYTECODE_VERSION;
+    fwrite(BYTECODE_MAGIC, sizeof(char), 4, output);
+    fwrite(&version, sizeof(int), 1, output);
+    fwrite(&hash, sizeof(hash), 1, output);
+    fwrite(&program.size, sizeof(int), 1, output);
+    fwrite(&program.nbNames, sizeof(int), 1, output);
+    fwrite(&program.nbCommands, sizeof(int), 1, output);
+    fwrite(&program.maxStack, sizeof(int), 1, output);
+    fwrite(&program.nbMatrices, sizeof(int), 1, output);
+    fwrite(program.instructions, sizeof(Instruction), program.size, output);
+    saveStrings(output, program.names, program.nbNames);
+    saveStrings(output, program.commands, program.nbCommands);
+    saveMatrices(output, program.matrices, program.nbMatrices);
+    return !fclose(output);
+}
+
+/**
+ * Read a list of strings
+ * @param input - The file to read
+ * @param size - Number of strings
+ * @return read strings, NULL if the file is too short
+ */
+char **readStrings(FILE *input, int size) {
+    char **strings = calloc(size ? size : 1, sizeof(char *));
+    int i;
+    for (i = 0; i < size; i++) {
+        int stringLength;
+        if (fread(&stringLength, sizeof(int), 1, input) != 1 || stringLength < 0 || stringLength > BYTECODE_MAX_STRING) break;
+        strings[i] = malloc((stringLength + 1) * sizeof(char));
+        if ((int) fread(strings[i], sizeof(char), stringLength, input) != stringLength) break;
+        strings[i][stringLength] = '\0';
+    }
+    if (i == size) return strings;
+    for (int j = 0; j < size; j++) free(strings[j]);
+    free(strings);
+    return NULL;
+}
+
+/**
+ * Read a list of matrices
+ * @param input - The file to read
+ * @param size - Number of matrices
+ * @return read matrices, NULL if the file is too short
+ */
+Matrix *readMatrices(FILE *input, int size) {
+    Matrix *matrices = calloc(size ? size : 1, sizeof(Matrix));
+    int i;
+    pauseArena(); //The matrices live as long as the program
+    for (i = 0; i < size; i++) {
+        int dimensions[2], j = 0;
+        if (fread(dimensions, sizeof(int), 2, input) != 2 || dimensions[0] <= 0 || dimensions[1] <= 0 ||
+            dimensions[1] > BYTECODE_MAX_VALUES / dimensions[0]) break;
+        matrices[i] = newMatrix(dimensions[0], dimensions[1]);
+        while (j < dimensions[0] && (int) fread(matrices[i].values[j], sizeof(double), dimensions[1], input) == dimensions[1]) j++;
+        if (j < dimensions[0]) break;
+    }
+    resumeArena();
+    if (i == size) return matrices;
+    for (int j = 0; j < size; j++) freeMatrix(&matrices[j]);
+    free(matrices);
+    return NULL;
+}
+
+/**
+ * Verify an instruction of a program
+ * This function verify the operands of an instruction and that the stack doesn't go out of its bounds
+ * @param program - The program containing the instruction
+ * @param index - Index of the instruction
+ * @param depth - Number of objects on the stack before the instruction, updated with its effect
+ * @param jumpDepths - Depth expected at each instruction after a jump, -1 if there is no jump to it
+ * @return result of the check
+ */
+char isValidInstruction(Program program, int index, int *depth, int *jumpDepths) {
+    Instruction instruction = program.instructions[index];
+    int popped = 0, pushed = 0;
+    if (jumpDepths[index] >= 0 && jumpDepths[index] != *depth) return 0;
+    if (instruction.opcode == OP_NUMBER || instruction.opcode == OP_TERM) pushed = 1;
+    else if (instruction.opcode == OP_LOAD) {
+        if (instruction.first < 0 || instruction.first >= program.nbNames) return 0;
+        pushed = 1;
+    } else if (instruction.opcode == OP_NEGATE) popped = pushed = 1;
+    else if (instruction.opcode == OP_OPERATION) {
+        popped = 2; pushed = 1;
+    } else if (instruction.opcode == OP_CALL) {
+        if (instruction.first < NB_FINAL_FUNCTIONS || instruction.first >= NB_FUNCTIONS || instruction.second < 0) return 0;
+        popped = instruction.second; pushed = 1;
+    } else if (instruction.opcode == OP_MATRIX) {
+        if (instruction.first <= 0 || instruction.second <= 0 || instruction.first > program.maxStack || instruction.second > program.maxStack) return 0;
+        popped = instruction.first * instruction.second; pushed = 1;
+    } else if (instruction.opcode == OP_STORE) {
+        if (instruction.first < 0 || instruction.first >= program.nbNames) return 0;
+        popped = 1;
+    } else if (instruction.opcode == OP_FINAL) {
+        if (instruction.first < 0 || instruction.first >= NB_FINAL_FUNCTIONS || instruction.second < 0 || instruction.second >= program.nbCommands) return 0;
+        popped = 1;
+    } else if (instruction.opcode == OP_DISCARD) popped = 1;
+    else if (instruction.opcode == OP_COMMAND) {
+        if (instruction.first < 0 || instruction.first >= program.nbCommands) return 0;
+    } else if (instruction.opcode == OP_FIND) { //Only forward jumps, arriving with the found subexpression on the stack
+        if (instruction.first < 0 || instruction.first >= program.nbCommands || instruction.second <= index || instruction.second > program.size) return 0;
+        if (*depth + 1 > program.maxStack || (jumpDepths[instruction.second] >= 0 && jumpDepths[instruction.second] != *depth + 1)) return 0;
+        jumpDepths[instruction.second] = *depth + 1;
+    } else if (instruction.opcode == OP_CONSTANT) {
+        if (instruction.first < 0 || instruction.first >= program.nbMatrices) return 0;
+        pushed = 1;
+    } else if (instruction.opcode == OP_REMEMBER) {
+        if (instruction.first < 0 || instruction.first >= program.nbCommands) return 0;
+        popped = pushed = 1;
+    } else return 0;
+    if (popped > *depth) return 0;
+    *depth += pushed - popped;
+    return *depth <= program.maxStack;
+}
+
+/**
+ * Verify if a program can be run
+ * This function verify every instruction, the stack must have the same depth on both paths of a jump
+ * @param program - The program to check
+ * @return result of the check
+ */
+char isValidProgram(Program program) {
+    int *jumpDepths = malloc((program.size + 1) * sizeof(int)), depth = 0;
+    char valid = 1;
+    for (int i = 0; i <= program.size; i++) jumpDepths[i] = -1;
+    for (int i = 0; valid && i < program.size; i++) valid = isValidInstruction(program, i, &depth, jumpDepths);
+    //A jump can go right after the last instruction
+    if (valid && jumpDepths[program.size] >= 0 && jumpDepths[program.size] != depth) valid = 0;
+    free(jumpDepths);
+    return valid;
+}
+
+Program readProgram(const char *link, unsigned long long hash) {
+    FILE *input = fopen(link, "rb");
+    if (!input) return (Program) {-1};
+    Program program = {-1, NULL, 0, NULL, 0, NULL, 0, 0, NULL};
+    char magic[4];
+    int version, header[5], sameMagic = 0;
+    unsigned long long savedHash;
+    if (fread(magic, sizeof(char), 4, input) == 4) while (sameMagic < 4 && magic[sameMagic] == BYTECODE_MAGIC[sameMagic]) sameMagic++;
+    //The saved program is only used if it was made from the same content by the same version
+    if (sameMagic == 4 && fread(&version, sizeof(int), 1, input) == 1 && version == BYTECODE_VERSION &&
+        fread(&savedHash, sizeof(savedHash), 1, input) == 1 && savedHash == hash &&
+        fread(header, sizeof(int), 5, input) == 5 && header[0] >= 0 && header[1] >= 0 && header[2] >= 0 && header[3] >= 0 && header[4] >= 0) {
+        program = (Program) {header[0], malloc((header[0] ? header[0] : 1) * sizeof(Instruction)), 0, NULL, 0, NULL, header[3], 0, NULL};
+        char **names = NULL, **commands = NULL;
+        Matrix *matrices = NULL;
+        if ((int) fread(program.instructions, sizeof(Instruction), program.size, input) == program.size &&
+            (names = readStrings(input, header[1])) && (commands = readStrings(input, header[2])) &&
+            (matrices = readMatrices(input, header[4]))) {
+            program.matrices = matrices; program.nbMatrices = header[4];
+        }
+        if (names) {
+            program.names = names; program.nbNames = header[1];
+        }
+        if (commands) {
+            program.commands = commands; program.nbCommands = header[2];
+        }
+        if (!matrices || !isValidProgram(program)) freeProgram(&program);
+    }
+    fclose(input);
+    return program;
+}
+
+void runProgram(Program program) {
+    Object *stack = malloc((program.maxStack ? program.maxStack : 1) * sizeof(Object));
+    Object *slots = malloc((program.nbNames ? program.nbNames : 1) * sizeof(Object));
+    char *resolved = calloc(program.nbNames ? program.nbNames : 1, sizeof(char));
+    int top = 0, line = 0;
+    char traced = 0;
+    ArenaMark mark = markArena();
+    for (int i = 0; i < program.size; i++) {
+        Instruction instruction = program.instructions[i];
+        if (tracing && !traced) traced = beginTraceEvent("script", "line", line + 1);
+        switch (instruction.opcode) {
+            case OP_NUMBER:
+                stack[top++] = (Object) {VARIABLE, .any.variable = newVariable(instruction.value)};
+                break;
+            case OP_TERM:
+                stack[top++] = (Object) {POLYNOMIAL, .any.polynomial = monomial(instruction.value, instruction.first)};
+                break;
+            case OP_LOAD: //The register is only searched the first time a slot is used
+                if (!resolved[instruction.first]) {
+                    slots[instruction.first] = checkObject(searchObject(mainRegister, program.names[instruction.first]));
+                    resolved[instruction.first] = 1;
+                }
+                stack[top++] = slots[instruction.first];
+                break;
+            case OP_NEGATE:
+                stack[top - 1] = applyNegation(stack[top - 1]);
+                break;
+            case OP_OPERATION:
+                top--;
+                if (stack[top - 1].type == UNUSED || stack[top].type == UNUSED) stack[top - 1] = newObject;
+                else stack[top - 1] = applyOperation(stack[top - 1], instruction.operator, stack[top]);
+                break;
+            case OP_CALL: {
+                Object result = newObject;
+                top -= instruction.second;
+                int j = 0;
+                while (j < instruction.second && stack[top + j].type != UNUSED) j++;
+                if (j == instruction.second) result = checkObject(applyFunction(instruction.first, stack + top, instruction.second));
+                stack[top++] = result;
+                break;
+            }
+            case OP_MATRIX:
+                top -= instruction.first * instruction.second;
+                stack[top] = buildMatrix(stack + top, instruction.first, instruction.second);
+                top++;
+                break;
+            case OP_STORE: {
+                Object result = materializeObject(checkObject(stack[--top]));
+                if (result.type == UNUSED) {
+                    writeError("Failed to do this operation, please verify it and try again\n");
+                    break;
+                }
+                char *name = extractUpToIndex(program.names[instruction.first], length(program.names[instruction.first]));
+                if (result.type == POLYNOMIAL) result.any.polynomial.name = name;
+                else if (result.type == MATRIX) result.any.matrix.name = name;
+                else result.any.variable.name = name;
+                addToRegister(mainRegister, result);
+                resolved[instruction.first] = 0; //The registered object counts its holders, it is searched again
+                flushOutput();
+                break;
+            }
+            case OP_FINAL:
+                applyFinalFunction(instruction.first, stack[--top], program.commands[instruction.second]);
+                flushOutput(); //The output of each line is displayed before the errors of the next ones
+                break;
+            case OP_DISCARD:
+                if (stack[--top].type == UNUSED) writeError("Failed to do this operation, please verify it and try again\n");
+                discardObject(stack[top]);
+                flushOutput();
+                break;
+            case OP_FIND: {
+                Object found = findSubexpression(mainRegister, program.commands[instruction.first]);
+                if (found.type != UNUSED) {
+                    stack[top++] = found;
+                    i = instruction.second - 1;
+                }
+                break;
+            }
+            case OP_CONSTANT: //The program holds its constants, they are shared with the objects created from them
+                if (!program.matrices[instruction.first].references) program.matrices[instruction.first] = shareMatrix(program.matrices[instruction.first]);
+                stack[top++] = (Object) {MATRIX, .any.matrix = program.matrices[instruction.first]};
+                break;
+            case OP_REMEMBER:
+                stack[top - 1] = rememberSubexpression(mainRegister, program.commands[instruction.first], stack[top - 1]);
+                break;
+            case OP_COMMAND: //The command can change the register, the slots must be searched again
+                executeCommand(program.commands[instruction.first]);
+                for (int j = 0; j < program.nbNames; j++) resolved[j] = 0;
+                break;
+            default:
+                break;
+        }
+        //A line ends once its result is stored, displayed or discarded, or once its command is applied
+        if (instruction.opcode >= OP_STORE && instruction.opcode <= OP_COMMAND) {
+            line++;
+            traceEnd(traced);
+            traced = 0;
+        }
+        //The temporaries of a line are freed once its result is stored or displayed, the results it found aren't used anymore
+        if (!top && (instruction.opcode == OP_STORE || instruction.opcode == OP_FINAL || instruction.opcode == OP_DISCARD)) {
+            releaseArena(mark);
+            releaseSubexpressions();
+            mark = markArena();
+        }
+    }
+    releaseArena(mark);
+    free(stack); free(slots); free(resolved);
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+/**
+ * @file bytecode.h Header file of bytecode.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_BYTECODE_H
+#define LINEARALGEBRA_BYTECODE_H
+
+#include "parser.h"
+
+#define BYTECODE_MAGIC "LABC" ///First bytes of a compiled script file
+#define BYTECODE_VERSION 4 ///Version of the compiled script format, to change with the instructions
+#define BYTECODE_EXTENSION ".lbc" ///Extension added to the link of a script to get the link of its compiled form
+#define BYTECODE_MAX_STRING (1 << 20) ///Longest name or command accepted when reading a compiled script
+#define BYTECODE_MAX_VALUES (1 << 26) ///Most values of a matrix accepted when reading a compiled script
+
+#define OP_NUMBER 0 ///Push a variable of the instruction's value
+#define OP_TERM 1 ///Push the polynomial value * X^first
+#define OP_LOAD 2 ///Push the object of slot first
+#define OP_NEGATE 3 ///Replace the top of the stack by its opposite
+#define OP_OPERATION 4 ///Replace the 2 objects on top of the stack by the result of operator
+#define OP_CALL 5 ///Replace the last second objects of the stack by the result of the function first
+#define OP_MATRIX 6 ///Replace the last first * second variables of the stack by a matrix of first rows and second columns
+#define OP_STORE 7 ///Pop the top of the stack and save it in the register under the name of slot first
+#define OP_FINAL 8 ///Pop the top of the stack and apply the final function first, second is the index of the command for errors
+#define OP_DISCARD 9 ///Pop the top of the stack, print an error if no object was calculated
+#define OP_COMMAND 10 ///Apply the command first with executeCommand, for lines that can't be compiled
+#define OP_FIND 11 ///Push the calculated subexpression of key first and jump to instruction second if it is known
+#define OP_REMEMBER 12 ///Remember the top of the stack as the subexpression of key first
+#define OP_CONSTANT 13 ///Push a copy of the matrix first of the program
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct Instruction
+ * Structure representing an instruction of the stack machine
+ */
+typedef struct {
+    char opcode; ///Operation to do
+    char operator; ///Operator of an operation
+    int first; ///First operand (slot, function, power, rows, command or matrix)
+    int second; ///Second operand (number of arguments, columns or command)
+    double value; ///Value of a number, coefficient of a term
+} Instruction;
+
+/**
+ * @struct Program
+ * Structure representing a compiled script, names are resolved in slots at compilation
+ */
+typedef struct {
+    int size; ///Number of instructions, negative for a program that couldn't be created
+    Instruction *instructions; ///Instructions
+    int nbNames; ///Number of slots
+    char **names; ///Name of the object of each slot
+    int nbCommands; ///Number of kept texts
+    char **commands; ///Texts kept by the program: commands for errors and lines that can't be compiled, keys of subexpressions
+    int maxStack; ///Highest number of objects on the stack while running
+    int nbMatrices; ///Number of matrix literals
+    Matrix *matrices; ///Values of the matrix literals only made of numbers, read once at compilation
+} Program;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Construction functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Compile a script
+ * This function compile every line of a script in a single program, each line is parsed only once
+ * @param script - Content of the script, its lines are cut in place
+ * @param size - Number of characters of the script, script[size] must exist
+ * @return compiled program
+ */
+Program compileScript(char *script, int size);
+
+/**
+ * Read a whole file
+ * @param link - Link of the file
+ * @param size - Return the number of bytes of the file
+ * @return content of the file, NULL if it can't be read
+ */
+char *readFileContent(const char *link, int *size);
+
+/**
+ * Load a script
+ * This function load the compiled form of a script saved next to it if it was compiled from the same content,
+ * it compile the script and save its compiled form otherwise
+ * @param link - Link of the script
+ * @return compiled program, of negative size if the script can't be read
+ */
+Program loadScript(const char *link);
+
+/**
+ * Free a program
+ * @param program - The program to free
+ */
+void freeProgram(Program *program);
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Save a program
+ * @param program - The program to save
+ * @param hash - Hash of the script the program was compiled from
+ * @param link - Link of the file to create
+ * @return 1 if the program was saved, 0 otherwise
+ */
+char saveProgram(Program program, unsigned long long hash, const char *link);
+
+/**
+ * Read a saved program
+ * @param link - Link of the saved program
+ * @param hash - Hash of the script the program must have been compiled from
+ * @return read program, of negative size if there is no valid saved program for this hash
+ */
+Program readProgram(const char *link, unsigned long long hash);
+
+/**
+ * Run a program
+ * This function run the instructions of a program on the main register
+ * @param program - The program to run
+ */
+void runProgram(Program program);
+
+#endif //LINEARALGEBRA_BYTECODE_H
\ No newline at end of file
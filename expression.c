@@ -0,0 +1,295 @@
+/**
+ * @file expression.c Functions on deferred matrix expressions
+ * @author Valentin Koeltgen
+ *
+ * This file contain the graph used to defer matrix operations until their result is needed, so that element-wise
+ * operations are calculated together instead of creating a matrix for each of them
+ */
+
+#include "expression.h"
+
+char showPlans = 0;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Construction functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Create an expression node
+ * @param type - Operation of the node
+ * @param rows - Number of rows of the result
+ * @param columns - Number of columns of the result
+ * @param left - First operand
+ * @param right - Second operand
+ * @return created node
+ */
+Expression *newExpression(char type, int rows, int columns, Expression *left, Expression *right) {
+    Expression *E = temporaryMalloc(sizeof(Expression));
+    *E = (Expression) {type, 1, rows, columns, nullMatrix, 0, NULL, left, right};
+    return E;
+}
+
+Expression *matrixExpression(Matrix M) {
+    Expression *E = newExpression(EXPRESSION_MATRIX, M.rows, M.columns, NULL, NULL);
+    E->matrix = M;
+    return E;
+}
+
+void freeExpression(Expression *E) {
+    if (E) {
+        freeExpression(E->left); freeExpression(E->right);
+        if (E->temporary) freeMatrix(&E->matrix);
+        temporaryFree(E->row);
+        temporaryFree(E);
+    }
+}
+
+/**
+ * Replace a node by a leaf
+ * This function free the operands of a node and make it a leaf of a calculated matrix
+ * @param E - The node to replace
+ * @param M - The calculated matrix, it will be freed with the node
+ */
+void becomeLeaf(Expression *E, Matrix M) {
+    freeExpression(E->left); freeExpression(E->right);
+    E->left = E->right = NULL;
+    E->type = EXPRESSION_MATRIX; E->matrix = M; E->temporary = 1;
+}
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+Expression *sumExpression(Expression *A, Expression *B, double sign) {
+    if (A->rows != B->rows || A->columns != B->columns) {
+        freeExpression(A); freeExpression(B);
+        return NULL;
+    }
+    return newExpression(EXPRESSION_SUM, A->rows, A->columns, A, scaleExpression(B, sign));
+}
+
+Expression *scaleExpression(Expression *A, double scalar) {
+    A->scalar *= scalar;
+    return A;
+}
+
+Expression *transposeExpression(Expression *A) {
+    if (A->type == EXPRESSION_TRANSPOSE) { //Transposing twice give back the operand
+        Expression *operand = scaleExpression(A->left, A->scalar);
+        A->left = NULL;
+        freeExpression(A);
+        return operand;
+    }
+    return newExpression(EXPRESSION_TRANSPOSE, A->columns, A->rows, A, NULL);
+}
+
+Expression *productExpression(Expression *A, Expression *B) {
+    if (A->columns != B->rows) {
+        freeExpression(A); freeExpression(B);
+        return NULL;
+    }
+    return newExpression(EXPRESSION_PRODUCT, A->rows, B->columns, A, B);
+}
+
+/**
+ * Calculate a row of an expression
+ * This function calculate a row of an expression without its scalar, the leaves don't need any calculation
+ * @param E - The prepared expression
+ * @param row - Index of the row
+ * @return values of the row
+ */
+const double *rowOf(Expression *E, int row) {
+    if (E->type == EXPRESSION_MATRIX) return E->matrix.values[row];
+    else if (E->type == EXPRESSION_TRANSPOSE) { //The operand is a leaf, its column is gathered
+        Expression *operand = E->left;
+        for (int j = 0; j < E->columns; j++) E->row[j] = operand->scalar * operand->matrix.values[j][row];
+    } else {
+        const double *left = rowOf(E->left, row), *right = rowOf(E->right, row);
+        double leftScalar = E->left->scalar, rightScalar = E->right->scalar;
+        for (int j = 0; j < E->columns; j++) E->row[j] = leftScalar * left[j] + rightScalar * right[j];
+    }
+    return E->row;
+}
+
+Matrix calculateExpression(Expression *E);
+
+void prepareExpression(Expression *E);
+
+/**
+ * Collect the factors of a product chain
+ * This function list from left to right the operands of consecutive products, the scalars of the inner products are
+ * moved to the whole chain
+ * @param E - Product of the chain
+ * @param chain - Top product of the chain
+ * @param factors - List of factors to complete
+ * @param size - Number of factors
+ */
+void collectFactors(Expression *E, Expression *chain, Expression ***factors, int *size) {
+    if (E->type == EXPRESSION_PRODUCT) {
+        if (E != chain) {
+            chain->scalar *= E->scalar; E->scalar = 1;
+        }
+        collectFactors(E->left, chain, factors, size);
+        collectFactors(E->right, chain, factors, size);
+    } else {
+        *factors = realloc(*factors, (*size + 1) * sizeof(Expression *));
+        (*factors)[(*size)++] = E;
+    }
+}
+
+/**
+ * Print a factor of a product chain
+ * @param factor - The prepared factor
+ */
+void printFactor(Expression *factor) {
+    Expression *leaf = factor->type == EXPRESSION_TRANSPOSE ? factor->left : factor;
+    if (factor->type == EXPRESSION_TRANSPOSE) writeText("trans(");
+    if (leaf->matrix.name) writeText(leaf->matrix.name);
+    else writeFormat("[%dx%d]", leaf->rows, leaf->columns);
+    if (factor->type == EXPRESSION_TRANSPOSE) writeText(")");
+}
+
+/**
+ * Print the plan of a product chain
+ * @param factors - Prepared factors of the chain
+ * @param split - Best split of each range of factors
+ * @param size - Number of factors
+ * @param first - First factor of the range to print
+ * @param last - Last factor of the range to print
+ */
+void printChainPlan(Expression **factors, const int *split, int size, int first, int last) {
+    if (first == last) printFactor(factors[first]);
+    else {
+        writeText("(");
+        printChainPlan(factors, split, size, first, split[first * size + last]);
+        writeText(" * ");
+        printChainPlan(factors, split, size, split[first * size + last] + 1, last);
+        writeText(")");
+    }
+}
+
+/**
+ * Multiply a range of a product chain
+ * This function multiply the factors of a range in the order given by the best splits
+ * @param factors - Prepared factors of the chain
+ * @param split - Best split of each range of factors
+ * @param size - Number of factors
+ * @param first - First factor of the range, it must be before the last
+ * @param last - Last factor of the range
+ * @return product of the range
+ */
+Matrix multiplyRange(Expression **factors, const int *split, int size, int first, int last) {
+    int middle = split[first * size + last];
+    Matrix operands[2]; char transposed[2] = {0, 0};
+    int bounds[2][2] = {{first, middle}, {middle + 1, last}};
+    for (int i = 0; i < 2; i++) {
+        if (bounds[i][0] < bounds[i][1]) operands[i] = multiplyRange(factors, split, size, bounds[i][0], bounds[i][1]);
+        else {
+            Expression *factor = factors[bounds[i][0]];
+            transposed[i] = factor->type == EXPRESSION_TRANSPOSE;
+            operands[i] = transposed[i] ? factor->left->matrix : factor->matrix;
+        }
+    }
+    KernelProbe probe = startKernel(KERNEL_MULTIPLY);
+    Matrix product = multiplyTransposed(operands[0], transposed[0], operands[1], transposed[1]);
+    endKernel(probe, 2.0 * product.rows * product.columns * (transposed[0] ? operands[0].rows : operands[0].columns));
+    //Products of sub ranges are only needed here
+    for (int i = 0; i < 2; i++) if (bounds[i][0] < bounds[i][1]) freeMatrix(&operands[i]);
+    return product;
+}
+
+Matrix multiplyChain(Expression *E) {
+    Expression **factors = NULL;
+    int size = 0;
+    collectFactors(E, E, &factors, &size);
+    //Factors become leaves or transposed leaves, their scalars are moved to the chain
+    int *dimensions = malloc((size + 1) * sizeof(int));
+    for (int i = 0; i < size; i++) {
+        Expression *factor = factors[i];
+        prepareExpression(factor);
+        if (factor->type == EXPRESSION_TRANSPOSE) {
+            E->scalar *= factor->scalar * factor->left->scalar;
+            factor->scalar = factor->left->scalar = 1;
+        } else {
+            if (factor->type != EXPRESSION_MATRIX) becomeLeaf(factor, calculateExpression(factor));
+            else E->scalar *= factor->scalar;
+            factor->scalar = 1;
+        }
+        dimensions[i] = factor->rows;
+    }
+    dimensions[size] = factors[size - 1]->columns;
+    //Cost of the best order of each range, ranges are solved by increasing length
+    double *cost = calloc(size * size, sizeof(double));
+    int *split = calloc(size * size, sizeof(int));
+    for (int length = 2; length <= size; length++) {
+        for (int first = 0; first + length - 1 < size; first++) {
+            int last = first + length - 1;
+            cost[first * size + last] = -1;
+            for (int middle = first; middle < last; middle++) {
+                double candidate = cost[first * size + middle] + cost[(middle + 1) * size + last] +
+                                   2.0 * dimensions[first] * dimensions[middle + 1] * dimensions[last + 1];
+                if (cost[first * size + last] < 0 || candidate < cost[first * size + last]) {
+                    cost[first * size + last] = candidate;
+                    split[first * size + last] = middle;
+                }
+            }
+        }
+    }
+    if (showPlans) {
+        double leftToRight = 0;
+        for (int i = 1; i < size; i++) leftToRight += 2.0 * dimensions[0] * dimensions[i] * dimensions[i + 1];
+        writeText("Product plan : ");
+        printChainPlan(factors, split, size, 0, size - 1);
+        writeFormat(", %.3g flops (%.3g from left to right)\n", cost[size - 1], leftToRight);
+    }
+    Matrix product = multiplyRange(factors, split, size, 0, size - 1);
+    free(factors); free(dimensions); free(cost); free(split);
+    return product;
+}
+
+/**
+ * Prepare an expression for the row evaluation
+ * This function calculate the product chains (and the transposed operands that aren't leaves), then the remaining
+ * nodes receive their row buffer
+ * @param E - The expression to prepare
+ */
+void prepareExpression(Expression *E) {
+    if (E->type == EXPRESSION_MATRIX) return;
+    if (E->type == EXPRESSION_PRODUCT) {
+        becomeLeaf(E, multiplyChain(E));
+        return;
+    }
+    prepareExpression(E->left);
+    if (E->right) prepareExpression(E->right);
+    if (E->type == EXPRESSION_TRANSPOSE && E->left->type != EXPRESSION_MATRIX) {
+        //Only a leaf can be read by columns
+        Expression *operand = E->left;
+        becomeLeaf(operand, calculateExpression(operand));
+        operand->scalar = 1;
+    }
+    if (!E->row) E->row = temporaryMalloc(E->columns * sizeof(double));
+}
+
+/**
+ * Calculate an expression without freeing it
+ * @param E - The expression to calculate
+ * @return calculated matrix
+ */
+Matrix calculateExpression(Expression *E) {
+    prepareExpression(E);
+    if (E->type == EXPRESSION_MATRIX && E->temporary && E->scalar == 1) { //Already calculated, it is given as it is
+        E->temporary = 0;
+        return E->matrix;
+    }
+    Matrix result = newMatrix(E->rows, E->columns);
+    for (int i = 0; i < E->rows; i++) {
+        const double *row = rowOf(E, i);
+        for (int j = 0; j < E->columns; j++) result.values[i][j] = E->scalar * row[j];
+    }
+    return result;
+}
+
+Matrix materialize(Expression *E) {
+    if (!E) return nullMatrix;
+    Matrix result = calculateExpression(E);
+    freeExpression(E);
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+/**
+ * @file expression.h Header file of expression.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_EXPRESSION_H
+#define LINEARALGEBRA_EXPRESSION_H
+
+#include "matrix.h"
+#include "profiler.h"
+
+#define EXPRESSION_MATRIX 0 ///Leaf of the graph, an already calculated matrix
+#define EXPRESSION_SUM 1 ///Sum of the 2 children
+#define EXPRESSION_TRANSPOSE 2 ///Transposed of the left child
+#define EXPRESSION_PRODUCT 3 ///Matrix product of the 2 children
+
+extern char showPlans; ///1 to display the order chosen for each product chain and its cost
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct Expression
+ * Structure representing a node of a deferred matrix expression, the value of a node is its scalar times the result of
+ * its operation
+ */
+typedef struct Expression {
+    char type; ///Operation of the node
+    double scalar; ///Factor applied to the result of the operation
+    int rows; ///Number of rows of the result
+    int columns; ///Number of columns of the result
+    Matrix matrix; ///Matrix of a leaf
+    char temporary; ///1 if the matrix of the leaf was calculated for the expression and must be freed with it
+    double *row; ///Buffer receiving a row of the result during the evaluation
+    struct Expression *left; ///First operand
+    struct Expression *right; ///Second operand
+} Expression;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Construction functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Create a leaf expression
+ * @param M - The matrix of the leaf, it isn't copied nor freed with the expression
+ * @return created expression
+ */
+Expression *matrixExpression(Matrix M);
+
+/**
+ * Free an expression
+ * This function free a whole expression graph and the matrices calculated for it
+ * @param E - The expression to free
+ */
+void freeExpression(Expression *E);
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Deferred sum
+ * This function create the expression A + sign * B, the operands become part of it
+ * @param A - The first operand
+ * @param B - The second operand
+ * @param sign - 1 for a sum, -1 for a difference
+ * @return created expression, NULL (and the operands are freed) if their sizes don't match
+ */
+Expression *sumExpression(Expression *A, Expression *B, double sign);
+
+/**
+ * Deferred scalar multiplication
+ * @param A - The expression to multiply, it is modified
+ * @param scalar - The scalar
+ * @return the multiplied expression
+ */
+Expression *scaleExpression(Expression *A, double scalar);
+
+/**
+ * Deferred transposition
+ * @param A - The expression to transpose, it becomes part of the result
+ * @return created expression
+ */
+Expression *transposeExpression(Expression *A);
+
+/**
+ * Deferred matrix multiplication
+ * @param A - The first operand
+ * @param B - The second operand
+ * @return created expression, NULL (and the operands are freed) if their sizes don't match
+ */
+Expression *productExpression(Expression *A, Expression *B);
+
+/**
+ * Multiply a product chain
+ * This function multiply consecutive products in the order needing the fewest operations, found by dynamic
+ * programming on the sizes of the factors. The scalar of the chain receive the scalars of its factors
+ * @param E - Top product of the chain
+ * @return product of the chain, without the scalar of E
+ */
+Matrix multiplyChain(Expression *E);
+
+/**
+ * Calculate an expression
+ * This function calculate the products of an expression, then all sums, scalar multiplications and transpositions are
+ * fused in a single pass over the rows of the result. The expression is freed
+ * @param E - The expression to calculate
+ * @return calculated matrix
+ */
+Matrix materialize(Expression *E);
+
+#endif //LINEARALGEBRA_EXPRESSION_H
\ No newline at end of file
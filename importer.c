@@ -0,0 +1,374 @@
+/**
+ * @file importer.c Functions importing matrices from text files
+ * @author Valentin Koeltgen
+ *
+ * This file contain the streaming import of CSV and Matrix Market files, each chunk of the file is split in groups of
+ * lines parsed by several threads
+ */
+
+#include "importer.h"
+#include "tracer.h"
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * Verify if a line is blank
+ * @param line - First character of the line
+ * @param end - End of the line
+ * @return result of the check
+ */
+char isBlankLine(const char *line, const char *end) {
+    while (line < end && (*line == ' ' || *line == '\t' || *line == '\r')) line++;
+    return line == end;
+}
+
+/**
+ * Read the next number of a line
+ * @param position - Position in the line, moved after the number and the blanks following it
+ * @param value - Return the number
+ * @return 1 if a number was read, 0 otherwise
+ */
+char readImportNumber(char **position, double *value) {
+    int size;
+    while (**position == ' ' || **position == '\t') (*position)++;
+    *value = parseDouble(*position, &size);
+    *position += size;
+    while (**position == ' ' || **position == '\t' || **position == '\r') (*position)++;
+    return size > 0;
+}
+
+/**
+ * Read a positive integer of a line
+ * @param position - Position in the line, moved after the integer and the blanks following it
+ * @param limit - Highest accepted value
+ * @param value - Return the integer
+ * @return 1 if an integer between 1 and limit was read, 0 otherwise
+ */
+char readImportIndex(char **position, long long limit, long long *value) {
+    double number;
+    if (!readImportNumber(position, &number) || number < 1 || number > (double) limit) return 0;
+    *value = (long long) number;
+    return number == (double) *value;
+}
+
+/**
+ * Add a parsed row or value to a task
+ * The lists double when they are full
+ * @param task - The task
+ * @param row - The parsed row of a CSV file, NULL for a value
+ * @param value - The parsed value of an array matrix
+ */
+void addImported(ImportTask *task, double *row, double value) {
+    if (task->nbValues == task->capacity) {
+        task->capacity = task->capacity ? 2 * task->capacity : 64;
+        if (row) task->rows = realloc(task->rows, task->capacity * sizeof(double *));
+        else task->values = realloc(task->values, task->capacity * sizeof(double));
+    }
+    if (row) task->rows[task->nbValues++] = row;
+    else task->values[task->nbValues++] = value;
+}
+
+/**
+ * Parse a line of values
+ * @param task - The task parsing the line
+ * @param line - First character of the line
+ * @param end - End of the line
+ * @return 1 if the line is valid, 0 otherwise
+ */
+char parseImportLine(ImportTask *task, char *line, char *end) {
+    Importer *importer = task->importer;
+    Matrix *M = &importer->matrix;
+    char *position = line;
+    if (importer->format == IMPORT_CSV) { //Values separated by commas, as many as the columns
+        double *row = poolMalloc(M->columns * sizeof(double));
+        char valid = 1;
+        for (int j = 0; valid && j < M->columns; j++) valid = readImportNumber(&position, &row[j]) && (j == M->columns - 1 || *position++ == ',');
+        if (!valid || position != end) {
+            poolFree(row);
+            return 0;
+        }
+        addImported(task, row, 0);
+    } else if (importer->format == IMPORT_ARRAY) {
+        double value;
+        while (position < end) {
+            if (!readImportNumber(&position, &value)) return 0;
+            addImported(task, NULL, value);
+        }
+    } else { //Entries are written directly, they are at different positions
+        long long row, column;
+        double value = 1;
+        if (!readImportIndex(&position, M->rows, &row) || !readImportIndex(&position, M->columns, &column) ||
+            (importer->format == IMPORT_COORDINATE && !readImportNumber(&position, &value)) || position != end) return 0;
+        M->values[row - 1][column - 1] = value;
+        if (importer->mirror && row != column) M->values[column - 1][row - 1] = importer->mirror * value;
+    }
+    task->nbRecords++;
+    return 1;
+}
+
+/**
+ * Parse the lines of a task
+ * This function is run by a thread, it stops at the first invalid line
+ * @param argument - The task
+ * @return NULL
+ */
+void *parseImportTask(void *argument) {
+    ImportTask *task = argument;
+    char traced = traceBegin("import", "import lines", -1);
+    for (char *line = task->start; line < task->end && !task->error;) {
+        char *end = line;
+        while (end < task->end && *end != '\n') end++;
+        task->nbLines++;
+        //Comments of Matrix Market files and blank lines are skipped
+        if (!isBlankLine(line, end) && (task->importer->format == IMPORT_CSV || *line != '%') && !parseImportLine(task, line, end)) {
+            task->error = task->nbLines;
+        }
+        line = end + 1;
+    }
+    traceEnd(traced);
+    return NULL;
+}
+
+/**
+ * Compare a word with an expected one, without considering the case
+ * @param word - First character of the word
+ * @param size - Number of characters of the word
+ * @param expected - The expected word, in lower case
+ * @return result of the comparison
+ */
+char isImportWord(const char *word, int size, const char *expected) {
+    int i = 0;
+    while (i < size && expected[i] && (word[i] == expected[i] || (word[i] >= 'A' && word[i] <= 'Z' && word[i] - 'A' + 'a' == expected[i]))) i++;
+    return i == size && !expected[i];
+}
+
+/**
+ * Read the banner of a Matrix Market file
+ * This function read "%%MatrixMarket matrix <coordinate|array> <real|integer|pattern> <general|symmetric|skew-symmetric>"
+ * @param importer - The import
+ * @param line - First character of the banner
+ * @param end - End of the banner
+ * @return 1 if the banner was read, 0 if it isn't a supported matrix
+ */
+char readImportBanner(Importer *importer, const char *line, const char *end) {
+    const char *words[5];
+    int sizes[5], nbWords = 0;
+    for (const char *position = line; position < end && nbWords < 5;) {
+        while (position < end && (*position == ' ' || *position == '\t' || *position == '\r')) position++;
+        if (position == end) break;
+        words[nbWords] = position;
+        while (position < end && *position != ' ' && *position != '\t' && *position != '\r') position++;
+        sizes[nbWords] = (int) (position - words[nbWords]);
+        nbWords++;
+    }
+    if (nbWords < 5 || !isImportWord(words[0], sizes[0], "%%matrixmarket") ||
+        !isImportWord(words[1], sizes[1], "matrix")) return 0;
+    char pattern = isImportWord(words[3], sizes[3], "pattern");
+    if (!pattern && !isImportWord(words[3], sizes[3], "real") && !isImportWord(words[3], sizes[3], "integer")) return 0;
+    if (isImportWord(words[2], sizes[2], "coordinate")) importer->format = pattern ? IMPORT_PATTERN : IMPORT_COORDINATE;
+    else if (isImportWord(words[2], sizes[2], "array") && !pattern) importer->format = IMPORT_ARRAY;
+    else return 0;
+    if (isImportWord(words[4], sizes[4], "symmetric")) importer->mirror = 1;
+    else if (isImportWord(words[4], sizes[4], "skew-symmetric")) importer->mirror = -1;
+    else if (!isImportWord(words[4], sizes[4], "general")) return 0;
+    return 1;
+}
+
+/**
+ * Move the position of the next value of an array matrix to a stored value
+ * Symmetric matrices only store their lower triangle, without the diagonal if they are skew-symmetric
+ * @param importer - The import
+ */
+void nextArrayPosition(Importer *importer) {
+    while (importer->column < importer->matrix.columns && importer->row >= importer->matrix.rows) {
+        importer->column++;
+        importer->row = importer->mirror ? importer->column + (importer->mirror < 0) : 0;
+    }
+}
+
+/**
+ * Read a header line
+ * The header of a CSV file is an optional line of names before the first line of values, which give the number of
+ * columns. The header of a Matrix Market file is its banner, comments and size line
+ * @param importer - The import
+ * @param line - First character of the line
+ * @param end - End of the line
+ * @return 1 if the line was read, 0 if it is the first line of values, -1 if it is invalid
+ */
+int readImportHeader(Importer *importer, char *line, char *end) {
+    if (importer->format == -1) return readImportBanner(importer, line, end) ? 1 : -1;
+    if (isBlankLine(line, end) || (importer->format != IMPORT_CSV && *line == '%')) return 1;
+    if (importer->format == IMPORT_CSV) {
+        char *position = line;
+        double value;
+        if (importer->header && !readImportNumber(&position, &value)) { //Names of the columns
+            importer->header = 0;
+            return 1;
+        }
+        int nbColumns = 1;
+        for (position = line; position < end; position++) if (*position == ',') nbColumns++;
+        importer->matrix.columns = nbColumns;
+        importer->ready = 1;
+        return 0;
+    }
+    //Size line "<rows> <columns> [<entries>]"
+    long long rows, columns;
+    char *position = line;
+    if (!readImportIndex(&position, IMPORT_MAX_VALUES, &rows) || !readImportIndex(&position, IMPORT_MAX_VALUES, &columns) ||
+        rows * columns > IMPORT_MAX_VALUES || (importer->mirror && rows != columns)) return -1;
+    if (importer->format != IMPORT_ARRAY) {
+        double nbEntries;
+        if (!readImportNumber(&position, &nbEntries) || nbEntries < 0 || nbEntries > (double) (rows * columns) ||
+            nbEntries != (double) (long long) nbEntries) return -1;
+        importer->nbEntries = (long long) nbEntries;
+    }
+    if (position != end) return -1;
+    pauseArena(); //Imported matrices are usually registered, they are allocated on the heap like the rows of a CSV file
+    importer->matrix = newMatrix((int) rows, (int) columns);
+    resumeArena();
+    importer->row = importer->mirror < 0;
+    nextArrayPosition(importer);
+    importer->ready = 1;
+    return 1;
+}
+
+/**
+ * Add the parsed lines of a task to the matrix
+ * @param importer - The import
+ * @param task - The finished task
+ * @return 1 if the values were added, 0 if an array matrix receive too many values
+ */
+char mergeImportTask(Importer *importer, ImportTask *task) {
+    Matrix *M = &importer->matrix;
+    if (importer->format == IMPORT_CSV) { //The list of rows doubles when it is full
+        if (M->rows + task->nbValues > importer->capacity) {
+            while (M->rows + task->nbValues > importer->capacity) importer->capacity = importer->capacity ? 2 * importer->capacity : 64;
+            M->values = poolRealloc(M->values, importer->capacity * sizeof(double *));
+        }
+        for (int i = 0; i < task->nbValues; i++) M->values[M->rows++] = task->rows[i];
+        task->nbValues = 0;
+    } else if (importer->format == IMPORT_ARRAY) {
+        for (int i = 0; i < task->nbValues; i++) {
+            if (importer->column == M->columns) return 0;
+            M->values[importer->row][importer->column] = task->values[i];
+            if (importer->mirror && importer->row != importer->column) M->values[importer->column][importer->row] = importer->mirror * task->values[i];
+            importer->row++;
+            nextArrayPosition(importer);
+        }
+    }
+    return 1;
+}
+
+/**
+ * Parse complete lines of values
+ * This function split the lines between several threads, each thread parse consecutive lines
+ * @param importer - The import
+ * @param start - First character of the lines
+ * @param end - Character after the last line
+ * @param nbThreads - Highest number of threads
+ * @return 1 if all lines are valid, 0 otherwise
+ */
+char parseImportLines(Importer *importer, char *start, char *end, int nbThreads) {
+    long long size = end - start;
+    int nbTasks = (int) (size / IMPORT_MIN_TASK_SIZE) + 1;
+    if (nbTasks > nbThreads) nbTasks = nbThreads;
+    ImportTask *tasks = calloc(nbTasks, sizeof(ImportTask));
+    pthread_t threads[IMPORT_MAX_THREADS];
+    char started[IMPORT_MAX_THREADS] = {0};
+    //The groups of lines have about the same size, they end after a new line
+    char *position = start;
+    for (int i = 0; i < nbTasks; i++) {
+        char *last = i == nbTasks - 1 ? end : start + size * (i + 1) / nbTasks;
+        if (last < position) last = position;
+        while (last < end && last > position && last[-1] != '\n') last++;
+        tasks[i] = (ImportTask) {position, last, importer, 0, 0, 0, 0, NULL, NULL, 0};
+        position = last;
+    }
+    //The first group is parsed by the current thread
+    for (int i = 1; i < nbTasks; i++) {
+        started[i] = !pthread_create(&threads[i], NULL, parseImportTask, &tasks[i]);
+    }
+    parseImportTask(&tasks[0]);
+    for (int i = 1; i < nbTasks; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+        else parseImportTask(&tasks[i]);
+    }
+    char valid = 1;
+    for (int i = 0; i < nbTasks; i++) {
+        if (valid && tasks[i].error) {
+            writeError("Invalid line %lld\n", importer->nbLines + tasks[i].error);
+            valid = 0;
+        }
+        if (valid) {
+            importer->nbLines += tasks[i].nbLines; importer->nbRecords += tasks[i].nbRecords;
+            if (!mergeImportTask(importer, &tasks[i])) {
+                writeError("Too many values for a %dx%d matrix\n", importer->matrix.rows, importer->matrix.columns);
+                valid = 0;
+            }
+        }
+        for (int j = 0; j < tasks[i].nbValues && tasks[i].rows; j++) poolFree(tasks[i].rows[j]);
+        free(tasks[i].rows); free(tasks[i].values);
+    }
+    free(tasks);
+    return valid;
+}
+
+Matrix importMatrixFile(const char *link, double *seconds) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    FILE *input = fopen(link, "rb");
+    if (!input) return nullMatrix;
+    int linkLength = length(link), extensionLength = length(MTX_EXTENSION);
+    char mtx = linkLength >= extensionLength && !shorterString(link + linkLength - extensionLength, MTX_EXTENSION);
+    Importer importer = {mtx ? -1 : IMPORT_CSV, 0, 1, 0, nullMatrix, 0, 0, 0, 0, 0, 0};
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    int nbThreads = processors < 1 ? 1 : processors > IMPORT_MAX_THREADS ? IMPORT_MAX_THREADS : (int) processors;
+    int capacity = IMPORT_CHUNK_SIZE, size = 0;
+    char *buffer = malloc((capacity + 1) * sizeof(char)), valid = 1, ended = 0;
+    while (valid && !ended) {
+        //The chunk is read after the incomplete line kept from the previous one
+        size += (int) fread(buffer + size, sizeof(char), capacity - size, input);
+        ended = size < capacity;
+        buffer[size] = '\0';
+        int complete = size;
+        if (!ended) while (complete > 0 && buffer[complete - 1] != '\n') complete--;
+        if (complete == 0 && !ended) { //A line longer than the buffer
+            capacity *= 2;
+            buffer = realloc(buffer, (capacity + 1) * sizeof(char));
+            continue;
+        }
+        //Header lines are read one by one, then the lines of values are parsed together
+        char *position = buffer;
+        while (valid && !importer.ready && position < buffer + complete) {
+            char *lineEnd = position;
+            while (lineEnd < buffer + complete && *lineEnd != '\n') lineEnd++;
+            int read = readImportHeader(&importer, position, lineEnd);
+            if (read < 0) writeError("Invalid line %lld\n", importer.nbLines + 1);
+            valid = read >= 0;
+            if (read > 0) {
+                importer.nbLines++;
+                position = lineEnd + (lineEnd < buffer + complete);
+            }
+        }
+        if (valid && importer.ready) valid = parseImportLines(&importer, position, buffer + complete, nbThreads);
+        for (int i = complete; i < size; i++) buffer[i - complete] = buffer[i];
+        size -= complete;
+    }
+    free(buffer);
+    fclose(input);
+    //All announced values must have been read
+    if (valid && (!importer.ready || (importer.format == IMPORT_CSV && importer.matrix.rows == 0) ||
+                  (importer.format == IMPORT_ARRAY && importer.column < importer.matrix.columns) ||
+                  ((importer.format == IMPORT_COORDINATE || importer.format == IMPORT_PATTERN) && importer.nbRecords != importer.nbEntries))) {
+        writeError("Missing values at the end of the file\n");
+        valid = 0;
+    }
+    if (!valid) {
+        freeMatrix(&importer.matrix);
+        return nullMatrix;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    *seconds = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+    return importer.matrix;
+}
\ No newline at end of file
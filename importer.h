@@ -0,0 +1,74 @@
+/**
+ * @file importer.h Header file of importer.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_IMPORTER_H
+#define LINEARALGEBRA_IMPORTER_H
+
+#include "matrix.h"
+
+#define IMPORT_CHUNK_SIZE (1 << 24) ///Number of bytes read at once, the last incomplete line is kept for the next chunk
+#define IMPORT_MAX_THREADS 16 ///Most threads parsing a chunk together
+#define IMPORT_MIN_TASK_SIZE (1 << 16) ///Fewest bytes given to a thread, smaller chunks use fewer threads
+#define MTX_EXTENSION ".mtx" ///Extension of the files imported in the Matrix Market format
+
+#define IMPORT_CSV 0 ///Rows of values separated by commas
+#define IMPORT_COORDINATE 1 ///Matrix Market entries "<row> <column> <value>"
+#define IMPORT_PATTERN 2 ///Matrix Market entries "<row> <column>" of value 1
+#define IMPORT_ARRAY 3 ///Matrix Market values column by column
+#define IMPORT_MAX_VALUES (1LL << 28) ///Most values of an imported matrix, coordinate matrices are imported in dense form
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct Importer
+ * Structure representing the state of an import, the header lines are read before the lines of values
+ */
+typedef struct {
+    char format; ///Format of the values, -1 while the banner of a Matrix Market file wasn't read
+    char mirror; ///Factor of the value mirrored across the diagonal: 1 if symmetric, -1 if skew-symmetric, 0 otherwise
+    char header; ///1 while the first line of a CSV file can be a header
+    char ready; ///1 once the size of the matrix is known, the following lines are values
+    Matrix matrix; ///Imported matrix
+    int capacity; ///Number of rows allocated for a CSV file
+    long long nbEntries; ///Number of entries announced by a coordinate matrix
+    int row; ///Row of the next value of an array matrix
+    int column; ///Column of the next value of an array matrix
+    long long nbLines; ///Number of lines read
+    long long nbRecords; ///Number of lines of values read
+} Importer;
+
+/**
+ * @struct ImportTask
+ * Structure representing the complete lines of a chunk parsed by a thread
+ */
+typedef struct {
+    char *start; ///First character of the lines
+    char *end; ///Character after the lines
+    Importer *importer; ///The import, its matrix receive the entries of a coordinate matrix directly
+    int nbLines; ///Number of lines parsed
+    int nbRecords; ///Number of lines of values parsed
+    int nbValues; ///Number of parsed rows of a CSV file or values of an array matrix
+    int capacity; ///Size of the list of parsed rows or values
+    double **rows; ///Parsed rows of a CSV file
+    double *values; ///Parsed values of an array matrix
+    int error; ///Index of the first invalid line among the parsed lines plus 1, 0 if all lines are valid
+} ImportTask;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Import a matrix from a text file
+ * This function stream a CSV file, or a Matrix Market file if the link ends with .mtx, by chunks. The lines of a chunk
+ * are parsed in parallel and their values are written directly in the matrix. A first line of a CSV file that isn't
+ * made of numbers is skipped as a header
+ * @param link - Link of the file
+ * @param seconds - Return the duration of the import
+ * @return imported matrix, null matrix if the file can't be read or contain an invalid line
+ */
+Matrix importMatrixFile(const char *link, double *seconds);
+
+#endif //LINEARALGEBRA_IMPORTER_H
\ No newline at end of file
@@ -10,42 +10,10 @@
 //Global register, all objects are stored here
 Register aRegister = newRegister, *mainRegister = &aRegister;
 
-Matrix readMatrixInString(const char *string) {
-    Matrix M = {NULL, NULL, 0, 0};
-    int index = 0;
-    while (string[index] && string[index] != '[') index++;
-    if (string[index]) {
-        int currentLine = 0, currentColumn;
-        //For each line
-        for (int nextSeparator, maxValuesPerLine = 0; string[index] && string[index] != ']'; currentLine++) {
-            //Add an empty line
-            M.values = realloc(M.values, (currentLine + 1) * sizeof(double*)); M.values[currentLine] = NULL;
-            //For each column
-            for (currentColumn = 0, nextSeparator = index + 1; (currentLine < 1 || currentColumn <= maxValuesPerLine) && string[nextSeparator] && string[nextSeparator] != ';' && string[nextSeparator] != ']'; currentColumn++) {
-                nextSeparator = index + 1;
-                //Add an empty cell
-                while (string[nextSeparator] && string[nextSeparator] != ',' && string[nextSeparator] != ';' && string[nextSeparator] != ']') nextSeparator++;
-                //If end of the string reached unexpectedly
-                if (!string[nextSeparator]) return nullMatrix;
-                else {
-                    M.values[currentLine] = realloc(M.values[currentLine], (currentColumn + 1) * sizeof(double));
-                    Object result = recursiveCommandDecomposition(extractBetweenIndexes(string, index + 1, nextSeparator - 1));
-                    if (result.type == VARIABLE) M.values[currentLine][currentColumn] = result.any.variable.value;
-                    else return nullMatrix;
-                }
-                index = nextSeparator;
-            }
-            if (currentLine == 0) maxValuesPerLine = currentColumn;
-            else if (currentColumn != maxValuesPerLine) return nullMatrix;
-        }
-        M.rows = currentLine; M.columns = currentColumn;
-        return M;
-    } else return nullMatrix;
-}
-
 Solutions *eigenValues(Matrix M) {
     char *stringForm = detOfStringMatrix(changeToPLambdaForm(toStringMatrix(M)));
     Object temp = recursiveCommandDecomposition(stringForm);
+    free(stringForm);
     if (temp.type == POLYNOMIAL) {
         return solve(temp.any.polynomial);
     } else return NULL;
@@ -88,44 +56,87 @@ Matrix triangularise(Matrix M) {
 }
 
 void readScriptFile(const char *link) {
-    FILE *input = fopen(link, "rb");
-    if (input) {
-        while (!feof(input)) { //Read a line, then execute it
-            char *command = readString(input);
-            if (command[0]) executeCommand(command);
-            free(command);
-        }
-    } else fprintf(stderr, "Script not found at %s\n", link);
+    char traced = traceBegin("script", "compile", -1);
+    Program program = loadScript(link);
+    traceEnd(traced);
+    if (program.size >= 0) {
+        runProgram(program);
+        freeProgram(&program);
+    } else writeError("Script not found at %s\n", link);
 }
 
-Object extractObject(const char *command) {
-    Object result = newObject;
-    if (isValidPolynomial(command)) { //Create polynomial
-        result = (Object) {POLYNOMIAL, .any.polynomial = stringToPolynomial(command)};
-    } else if (containCharInOrder(command, "[]")) { //Create matrix
-        result = (Object) {MATRIX, .any.matrix = readMatrixInString(command)};
-    } else if (onlyContainValue(command)) { //Create variable
-        result = (Object) {VARIABLE, .any.variable = newVariable(readDoubleInString(command, NULL))};
-    } else { //Search for existing object
-        result = searchObject(mainRegister, command);
-    }
-    return checkObject(result);
+char isMatrixObject(Object object) {
+    return object.type == MATRIX || object.type == EXPRESSION;
+}
+
+Expression *toExpression(Object object) {
+    if (object.type == EXPRESSION) return object.any.expression;
+    else return matrixExpression(object.any.matrix);
+}
+
+Object materializeObject(Object object) {
+    if (object.type == EXPRESSION) return checkObject((Object) {MATRIX, .any.matrix = materialize(object.any.expression)});
+    else return object;
+}
+
+void discardObject(Object object) {
+    if (object.type == EXPRESSION) freeExpression(object.any.expression);
+}
+
+/**
+ * Number of terms of a polynomial
+ * @param F - The polynomial
+ * @return number of stored coefficients
+ */
+int termsOf(Polynomial F) {
+    return isSparse(F) ? F.nbTerms : F.highestDegree + 1;
+}
+
+/**
+ * Estimated flops of a polynomial operation
+ * Products are counted as classical products, the Karatsuba and Newton methods do fewer operations on large polynomials
+ * @param F - Left operand
+ * @param operator - The operation
+ * @param G - Right operand
+ * @return estimated floating point operations
+ */
+double polynomialFlops(Polynomial F, char operator, Polynomial G) {
+    if (operator == '*') return 2.0 * termsOf(F) * termsOf(G);
+    else if (operator == '/') return F.highestDegree < G.highestDegree ? 0 : 2.0 * (F.highestDegree - G.highestDegree + 1) * (G.highestDegree + 1);
+    else return termsOf(F) + termsOf(G);
+}
+
+/**
+ * Apply an operation on 2 polynomials
+ * @param F - Left operand
+ * @param operator - The operation
+ * @param G - Right operand
+ * @return result of the operation
+ */
+Polynomial applyPolynomialOperation(Polynomial F, char operator, Polynomial G) {
+    KernelProbe probe = startKernel(operator == '*' ? KERNEL_P_MULTIPLY : operator == '/' ? KERNEL_P_DIVIDE : KERNEL_P_ADD);
+    Polynomial result = {NULL, NULL, 0, NULL, 0, NULL};
+    if (operator == '+') result = pAdd(F, G);
+    else if (operator == '-') result = pMinus(F, G);
+    else if (operator == '*') result = pMultiply(F, G);
+    else if (operator == '/') result = pLongDivide(F, G);
+    endKernel(probe, polynomialFlops(F, operator, G));
+    return result;
 }
 
 Object applyOperation(Object leftOperand, char operator, Object rightOperand) {
     Object result = newObject;
     if (rightOperand.type == POLYNOMIAL && leftOperand.type == POLYNOMIAL) { //F(X) +,-,*,/ G(X)
         result.type = POLYNOMIAL;
-        if (operator == '+') result.any.polynomial = pAdd(leftOperand.any.polynomial, rightOperand.any.polynomial);
-        else if (operator == '-') result.any.polynomial = pMinus(leftOperand.any.polynomial, rightOperand.any.polynomial);
-        else if (operator == '*') result.any.polynomial = pMultiply(leftOperand.any.polynomial, rightOperand.any.polynomial);
-        else if (operator == '/') result.any.polynomial = pLongDivide(leftOperand.any.polynomial, rightOperand.any.polynomial);
-    } else if (rightOperand.type == MATRIX && leftOperand.type == MATRIX) { //M +,-,* N
-        result.type = MATRIX;
-        if (operator == '+') result.any.matrix = sum(leftOperand.any.matrix, rightOperand.any.matrix);
-        else if (operator == '-') result.any.matrix = minus(leftOperand.any.matrix, rightOperand.any.matrix);
-        else if (operator == '*') result.any.matrix = multiply(leftOperand.any.matrix, rightOperand.any.matrix);
-        else if (operator == '/') result.type = UNUSED;
+        result.any.polynomial = applyPolynomialOperation(leftOperand.any.polynomial, operator, rightOperand.any.polynomial);
+    } else if (isMatrixObject(leftOperand) && isMatrixObject(rightOperand)) { //M +,-,* N, deferred
+        Expression *left = toExpression(leftOperand), *right = toExpression(rightOperand);
+        if (operator == '+' || operator == '-') result.any.expression = sumExpression(left, right, operator == '+' ? 1 : -1);
+        else if (operator == '*') result.any.expression = productExpression(left, right);
+        else {
+            freeExpression(left); freeExpression(right);
+        }
+        if (result.any.expression) result.type = EXPRESSION;
     } else if (rightOperand.type == VARIABLE && leftOperand.type == VARIABLE) { //x +,-,*,/ y
         result.type = VARIABLE;
         if (operator == '+') result.any.variable = newVariable(leftOperand.any.variable.value + rightOperand.any.variable.value);
@@ -135,10 +146,10 @@ Object applyOperation(Object leftOperand, char operator, Object rightOperand) {
             if (rightOperand.any.variable.value == 0) return newObject;
             result.any.variable = newVariable(leftOperand.any.variable.value / rightOperand.any.variable.value);
         }
-    } else if (operator == '*' && ((rightOperand.type == MATRIX && leftOperand.type == VARIABLE) || (rightOperand.type == VARIABLE && leftOperand.type == MATRIX))) { //M * x
-        result.type = MATRIX;
-        if (leftOperand.type == VARIABLE) result.any.matrix = scalarMultiply(rightOperand.any.matrix, leftOperand.any.variable.value);
-        else result.any.matrix = scalarMultiply(leftOperand.any.matrix, rightOperand.any.variable.value);
+    } else if (operator == '*' && ((isMatrixObject(rightOperand) && leftOperand.type == VARIABLE) || (rightOperand.type == VARIABLE && isMatrixObject(leftOperand)))) { //M * x, deferred
+        result.type = EXPRESSION;
+        if (leftOperand.type == VARIABLE) result.any.expression = scaleExpression(toExpression(rightOperand), leftOperand.any.variable.value);
+        else result.any.expression = scaleExpression(toExpression(leftOperand), rightOperand.any.variable.value);
     } else if ((rightOperand.type == POLYNOMIAL && leftOperand.type == VARIABLE) || (rightOperand.type == VARIABLE && leftOperand.type == POLYNOMIAL)) { //P(X) +,-,*,/ x
         result.type = POLYNOMIAL;
         Polynomial *polynomial; Variable *variable;
@@ -149,140 +160,465 @@ Object applyOperation(Object leftOperand, char operator, Object rightOperand) {
             polynomial = &leftOperand.any.polynomial;
             variable = &rightOperand.any.variable;
         }
-        if (operator == '+') result.any.polynomial = pAdd(*polynomial, variableToPolynomial(*variable));
-        else if (operator == '*') result.any.polynomial = pMultiply(*polynomial, variableToPolynomial(*variable));
-        else if (operator == '-') {
-            if (rightOperand.type == VARIABLE) result.any.polynomial = pMinus(*polynomial, variableToPolynomial(*variable));
-            else result.any.polynomial = pMinus(variableToPolynomial(*variable), *polynomial);
-        } else if (operator == '/') {
-            //Polynomial temp = newPolynomial(polynomial->highestDegree);
-            if (rightOperand.type == VARIABLE) result.any.polynomial = pLongDivide(*polynomial, variableToPolynomial(*variable));
-            else result.any.polynomial = pLongDivide(variableToPolynomial(*variable), *polynomial);
-        }
+        if (rightOperand.type == VARIABLE) result.any.polynomial = applyPolynomialOperation(*polynomial, operator, variableToPolynomial(*variable));
+        else result.any.polynomial = applyPolynomialOperation(variableToPolynomial(*variable), operator, *polynomial);
     }
     return checkObject(result);
 }
 
-Object recursiveCommandDecomposition(const char *command) {
-    //If we have global parenthesis, we get rid of them
-    if (everythingIsBetweenParenthesis(command)) command = extractBetweenChar(command, '(', ')');
-
-    if (containString(command, "=")) { //Declaration of an object
-        Object result = checkObject(recursiveCommandDecomposition(extractBetweenChar(command, '=', '\0')));
-        char *name = firstWord(command);
-        if (result.type != UNUSED && shorterString("X", name) && !containString(name, "[") && !containString(name, "]") && !onlyContainValue(name)) {
-            if (result.type == POLYNOMIAL) result.any.polynomial.name = name;
-            else if (result.type == MATRIX) result.any.matrix.name = name;
-            else if (result.type == VARIABLE) result.any.variable.name = name;
-            addToRegister(mainRegister, result);
-            return result;
-        } else if (!shorterString("X", name)) fprintf(stderr, "Error, can't use 'X' as a variable name\n");
-    } else if (operatorWithoutDepth(command)) { //Mathematical operation
-        int firstIndex = 0, secondIndex = 0;
-        //We change the indexes to surround the next operand
-        nextOperator(command, &firstIndex, &secondIndex);
-        //We calculate the left part (before the indexes
-        Object result = recursiveCommandDecomposition(extractUpToIndex(command, firstIndex));
-        //We add all other operand one by one
-        while (result.type != UNUSED && command[firstIndex]) {
-            Object rightPart = recursiveCommandDecomposition(extractBetweenIndexes(command, firstIndex + 1, secondIndex));
-            if (rightPart.type != UNUSED) result = applyOperation(result, command[firstIndex], rightPart);
-            firstIndex = secondIndex;
-            nextOperator(command, &firstIndex, &secondIndex);
+/**
+ * Convert a variable argument to a polynomial
+ * @param argument - The argument to convert
+ * @return the argument, as a polynomial if it was a variable
+ */
+Object asPolynomial(Object argument) {
+    if (argument.type == VARIABLE) return (Object) {POLYNOMIAL, .any.polynomial = variableToPolynomial(argument.any.variable)};
+    else return argument;
+}
+
+/**
+ * Estimated flops of the cofactor expansion of a determinant
+ * @param size - Number of rows of the matrix
+ * @return estimated floating point operations
+ */
+double cofactorFlops(int size) {
+    double flops = 0;
+    for (int n = 2; n <= size; n++) flops = n * (flops + 3);
+    return flops;
+}
+
+/**
+ * Estimated flops of a function
+ * @param function - Index of the function
+ * @param arguments - Calculated arguments of the function
+ * @param nbArguments - Number of arguments
+ * @return estimated floating point operations, 0 if they can't be estimated from the sizes of the arguments
+ */
+double functionFlops(int function, Object *arguments, int nbArguments) {
+    if (nbArguments < 1) return 0;
+    Object first = arguments[0];
+    if (first.type == MATRIX) {
+        double rows = first.any.matrix.rows, columns = first.any.matrix.columns;
+        if (function == FUNCTION_DETERMINANT) return cofactorFlops(first.any.matrix.rows);
+        else if (function == FUNCTION_ADJUGATE) return rows * rows * cofactorFlops(first.any.matrix.rows - 1);
+        else if (function == FUNCTION_INVERSE) return cofactorFlops(first.any.matrix.rows) + rows * rows * (cofactorFlops(first.any.matrix.rows - 1) + 1);
+        else if (function == FUNCTION_TRACE) return rows < columns ? rows : columns;
+        else if (function == FUNCTION_SOLVE) return rows * columns * (rows + 1); //Gaussian elimination
+    } else if (first.type == POLYNOMIAL) {
+        if (function == FUNCTION_DERIVE) return termsOf(first.any.polynomial);
+        else if (function == FUNCTION_EVALUATE && nbArguments == 2 && arguments[1].type == MATRIX) { //As many Horner evaluations
+            return 2.0 * termsOf(first.any.polynomial) * arguments[1].any.matrix.rows * arguments[1].any.matrix.columns;
         }
-        return result;
-    } else if (containString(command, "triangularise") && containCharInOrder(command, "triangularise()")) {
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == MATRIX) return (Object) {MATRIX, .any.matrix = triangularise(result.any.matrix)};
-    } else if (containString(command, "trans") && containCharInOrder(command, "trans()")) {
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == MATRIX) return (Object) {MATRIX, .any.matrix = transpose(result.any.matrix)};
-    } else if (containString(command, "adj") && containCharInOrder(command, "adj()")) {
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == MATRIX) return (Object) {MATRIX, .any.matrix = adjugate(result.any.matrix)};
-    } else if (containString(command, "inv") && containCharInOrder(command, "inv()")) {
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == MATRIX) return (Object) {MATRIX, .any.matrix = inverse(result.any.matrix)};
-    } else if (containString(command, "eigVectors") && containCharInOrder(command, "eigVectors()")) {
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == MATRIX) return (Object) {MATRIX, .any.matrix = eigenVectors(result.any.matrix)};
-    } else if (containString(command, "PLambda") && containCharInOrder(command, "PLambda()")) {
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == MATRIX) {
-            char *stringForm = detOfStringMatrix(changeToPLambdaForm(toStringMatrix(result.any.matrix)));
-            Object temp = recursiveCommandDecomposition(stringForm);
-            if (temp.type == POLYNOMIAL) return (Object) {POLYNOMIAL, .any.polynomial = temp.any.polynomial};
-            else return newObject;
+    }
+    return 0;
+}
+
+/**
+ * Apply a function on calculated arguments
+ * @param function - Index of the function
+ * @param arguments - Arguments of the function, the deferred matrices are calculated in place
+ * @param nbArguments - Number of arguments
+ * @return object containing the result, an unused object if the arguments don't fit the function
+ */
+Object calculateFunction(int function, Object *arguments, int nbArguments) {
+    if (function == FUNCTION_TRANSPOSE && nbArguments == 1 && isMatrixObject(arguments[0])) { //Deferred
+        return (Object) {EXPRESSION, .any.expression = transposeExpression(toExpression(arguments[0]))};
+    }
+    //Other functions need calculated matrices
+    for (int i = 0; i < nbArguments; i++) arguments[i] = materializeObject(arguments[i]);
+    if (nbArguments == 1) {
+        Object argument = arguments[0];
+        if (argument.type == MATRIX) {
+            Matrix M = argument.any.matrix;
+            if (function == FUNCTION_TRIANGULARISE) return (Object) {MATRIX, .any.matrix = triangularise(M)};
+            else if (function == FUNCTION_ADJUGATE) return (Object) {MATRIX, .any.matrix = adjugate(M)};
+            else if (function == FUNCTION_INVERSE) return (Object) {MATRIX, .any.matrix = inverse(M)};
+            else if (function == FUNCTION_EIGEN_VECTORS) return (Object) {MATRIX, .any.matrix = eigenVectors(M)};
+            else if (function == FUNCTION_P_LAMBDA) {
+                char *stringForm = detOfStringMatrix(changeToPLambdaForm(toStringMatrix(M)));
+                Object temp = recursiveCommandDecomposition(stringForm);
+                free(stringForm);
+                if (temp.type == POLYNOMIAL) return temp;
+            } else if (function == FUNCTION_TRACE) return (Object) {VARIABLE, .any.variable = newVariable(trace(M))};
+            else if (function == FUNCTION_DETERMINANT && M.columns == M.rows) return (Object) {VARIABLE, .any.variable = newVariable(det(M))};
+        } else if (function == FUNCTION_DERIVE && (argument.type == POLYNOMIAL || argument.type == VARIABLE)) {
+            return (Object) {POLYNOMIAL, .any.polynomial = derive(asPolynomial(argument).any.polynomial)};
+        }
+    } else if (nbArguments == 2) {
+        Object first = arguments[0], second = arguments[1];
+        if (function == FUNCTION_INTERPOLATE && first.type == MATRIX && second.type == MATRIX) {
+            int nbXs, nbYs;
+            double *xValues = vectorToArray(first.any.matrix, &nbXs), *yValues = vectorToArray(second.any.matrix, &nbYs);
+            if (xValues && yValues && nbXs == nbYs) return checkObject((Object) {POLYNOMIAL, .any.polynomial = interpolate(xValues, yValues, nbXs)});
+        } else if (function == FUNCTION_EVALUATE && second.type == MATRIX) {
+            int nbPoints;
+            first = asPolynomial(first);
+            double *values = vectorToArray(second.any.matrix, &nbPoints);
+            if (first.type == POLYNOMIAL && values) return (Object) {MATRIX, .any.matrix = arrayToVector(multipointEvaluate(first.any.polynomial, values, nbPoints), nbPoints)};
+        } else if (function == FUNCTION_SHIFT && second.type == VARIABLE) {
+            first = asPolynomial(first);
+            if (first.type == POLYNOMIAL) return (Object) {POLYNOMIAL, .any.polynomial = taylorShift(first.any.polynomial, second.any.variable.value)};
+        } else if (function == FUNCTION_GCD || function == FUNCTION_COMPOSE) {
+            first = asPolynomial(first); second = asPolynomial(second);
+            if (first.type == POLYNOMIAL && second.type == POLYNOMIAL) {
+                if (function == FUNCTION_GCD) return (Object) {POLYNOMIAL, .any.polynomial = pGcd(first.any.polynomial, second.any.polynomial)};
+                else return (Object) {POLYNOMIAL, .any.polynomial = compose(first.any.polynomial, second.any.polynomial)};
+            }
+        }
+    }
+    return newObject;
+}
+
+Object applyFunction(int function, Object *arguments, int nbArguments) {
+    KernelProbe probe = startKernel(KERNEL_FUNCTIONS + function);
+    Object result = calculateFunction(function, arguments, nbArguments);
+    endKernel(probe, functionFlops(function, arguments, nbArguments));
+    return result;
+}
+
+Object applyNegation(Object operand) {
+    if (operand.type == UNUSED) return newObject;
+    return applyOperation((Object) {VARIABLE, .any.variable = newVariable(-1)}, '*', operand);
+}
+
+void saveObject(Object object, const char *link) {
+    object = materializeObject(checkObject(object));
+    if (object.type != MATRIX) writeError("Only matrices can be saved\n");
+    else if (saveMatrixFile(object.any.matrix, link)) writeStatus("Matrix saved in %s\n", link);
+    else writeError("Couldn't save the matrix in %s\n", link);
+}
+
+Object buildMatrix(Object *cells, int rows, int columns) {
+    Matrix M = newMatrix(rows, columns);
+    for (int i = 0; i < rows * columns; i++) {
+        if (cells[i].type != VARIABLE) {
+            freeMatrix(&M);
+            return newObject;
         }
-    } else if (containString(command, "derive") && containCharInOrder(command, "derive()")) {
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == POLYNOMIAL || result.type == VARIABLE) {
-            if (result.type == POLYNOMIAL) return (Object) {POLYNOMIAL, .any.polynomial = derive(result.any.polynomial)};
-            else return (Object) {POLYNOMIAL, .any.polynomial = derive(variableToPolynomial(result.any.variable))};
+        M.values[i / columns][i % columns] = cells[i].any.variable.value;
+    }
+    return (Object) {MATRIX, .any.matrix = M};
+}
+
+Object evaluateNode(Node *node) {
+    if (!node) return newObject;
+    if (node->type == NODE_NUMBER) {
+        return (Object) {VARIABLE, .any.variable = newVariable(node->value)};
+    } else if (node->type == NODE_TERM) {
+        return (Object) {POLYNOMIAL, .any.polynomial = monomial(node->value, node->power)};
+    } else if (node->type == NODE_NAME) {
+        return checkObject(searchObject(mainRegister, node->name));
+    } else if (node->type == NODE_NEGATE) {
+        return applyNegation(evaluateNode(node->children[0]));
+    } else if (node->type == NODE_OPERATION) {
+        Object left = evaluateNode(node->children[0]);
+        if (left.type == UNUSED) return newObject;
+        Object right = evaluateNode(node->children[1]);
+        if (right.type == UNUSED) return newObject;
+        return applyOperation(left, node->operator, right);
+    } else if (node->type == NODE_CALL && (node->function == FUNCTION_LOAD || node->function == FUNCTION_IMPORT)) {
+        //The file is read again at every call
+        if (node->nbChildren != 1 || node->children[0]->type != NODE_STRING) return newObject;
+        const char *link = node->children[0]->name;
+        double seconds;
+        KernelProbe probe = startKernel(KERNEL_FUNCTIONS + node->function);
+        Matrix M = node->function == FUNCTION_LOAD ? loadMatrixFile(link) : importMatrixFile(link, &seconds);
+        endKernel(probe, 0);
+        if (!M.values) writeError("Couldn't %s a matrix from %s\n", functionNames[node->function], link);
+        else if (node->function == FUNCTION_IMPORT) {
+            //The lines of a Matrix Market file are entries, the rows of the matrix are reported for every format
+            writeStatus("Imported %d rows in %.3f s (%.0f rows/s)\n", M.rows, seconds, seconds > 0 ? M.rows / seconds : 0);
         }
-    } else if (containString(command, "trace") && containCharInOrder(command, "trace()")) {
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == MATRIX) return (Object) {VARIABLE, .any.variable = newVariable(trace(result.any.matrix))};
-    } else if (containString(command, "det") && containCharInOrder(command, "det()")) {
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == MATRIX) {
-            if (result.any.matrix.columns == result.any.matrix.rows) {
-                return (Object) {VARIABLE, .any.variable = newVariable(det(result.any.matrix))};
-            } else return newObject;
+        return checkObject((Object) {MATRIX, .any.matrix = M});
+    } else if (node->type == NODE_CALL) {
+        if (node->function < NB_FINAL_FUNCTIONS) return newObject; //Final functions can't be part of an operation
+        //Identical calls on unchanged objects are only calculated once
+        char *key = isRememberedCall(node) ? subexpressionKey(node) : NULL;
+        Object result = key ? findSubexpression(mainRegister, key) : newObject;
+        if (result.type == UNUSED) {
+            Object *arguments = malloc((node->nbChildren ? node->nbChildren : 1) * sizeof(Object));
+            int i;
+            for (i = 0; i < node->nbChildren; i++) {
+                arguments[i] = evaluateNode(node->children[i]);
+                if (arguments[i].type == UNUSED) break;
+            }
+            if (i == node->nbChildren) result = checkObject(applyFunction(node->function, arguments, node->nbChildren));
+            if (key) result = rememberSubexpression(mainRegister, key, result);
+            free(arguments);
         }
+        free(key);
+        return result;
+    } else if (node->type == NODE_MATRIX && node->matrix.values) { //Values already read by the parser
+        Object result = {MATRIX, .any.matrix = node->matrix};
+        node->matrix = nullMatrix;
+        return result;
+    } else if (node->type == NODE_MATRIX) {
+        Object *cells = malloc(node->nbChildren * sizeof(Object));
+        for (int i = 0; i < node->nbChildren; i++) cells[i] = evaluateNode(node->children[i]);
+        Object result = buildMatrix(cells, node->rows, node->columns);
+        free(cells);
+        return result;
+    } else if (node->type == NODE_ASSIGNMENT) {
+        Object result = materializeObject(checkObject(evaluateNode(node->children[0])));
+        if (result.type == UNUSED) return newObject;
+        char *name = extractUpToIndex(node->name, length(node->name));
+        if (result.type == POLYNOMIAL) result.any.polynomial.name = name;
+        else if (result.type == MATRIX) result.any.matrix.name = name;
+        else if (result.type == VARIABLE) result.any.variable.name = name;
+        addToRegister(mainRegister, result);
+        return result;
     }
-    else return extractObject(command);
     return newObject;
 }
 
+Object recursiveCommandDecomposition(const char *command) {
+    char traced = traceBegin("phase", "parse", -1);
+    Node *root = parseCommand(command, 0);
+    traceEnd(traced);
+    traced = traceBegin("phase", "evaluate", -1);
+    Object result = materializeObject(evaluateNode(root));
+    traceEnd(traced);
+    freeNode(root);
+    return result;
+}
+
+void applyFinalFunction(int function, Object argument, const char *command) {
+    argument = materializeObject(checkObject(argument));
+    KernelProbe probe = startKernel(KERNEL_FUNCTIONS + function);
+    if (function == FUNCTION_DISPLAY) {
+        if (argument.type == UNUSED) writeError("Couldn't calculate %s\n", command);
+        else if (argument.type == POLYNOMIAL) printPolynomial(argument.any.polynomial);
+        else if (argument.type == MATRIX) printMatrix(argument.any.matrix);
+        else printVariable(argument.any.variable);
+    } else if (function == FUNCTION_EIGEN_VALUES) { //Eigen values
+        if (argument.type == MATRIX) printSolutions(eigenValues(argument.any.matrix));
+        else writeError("Couldn't calculate %s\n", command);
+    } else if (function == FUNCTION_SQUARE_FREE) { //Square-free decomposition
+        if (argument.type == POLYNOMIAL) {
+            Factorization factorization = squareFreeDecomposition(argument.any.polynomial);
+            printFactorization(factorization);
+            freeFactorization(&factorization);
+        } else writeError("Couldn't calculate %s\n", command);
+    } else if (function == FUNCTION_SOLVE) { //Solve polynomial or matrix
+        if (argument.type == POLYNOMIAL) printSolutions(solve(argument.any.polynomial));
+        else if (argument.type == MATRIX) printMatrix(solveAugmentedMatrix(argument.any.matrix));
+        else writeError("Couldn't calculate %s\n", command);
+    }
+    endKernel(probe, functionFlops(function, &argument, 1));
+}
+
+void executeNode(Node *root, const char *command) {
+    if (root && root->type == NODE_CALL && root->function == FUNCTION_SAVE && root->nbChildren == 2 &&
+        root->children[1]->type == NODE_STRING) {
+        saveObject(evaluateNode(root->children[0]), root->children[1]->name);
+    } else if (root && root->type == NODE_CALL && root->function < NB_FINAL_FUNCTIONS && root->function != FUNCTION_SAVE &&
+               root->nbChildren == 1) { //Final commands
+        applyFinalFunction(root->function, evaluateNode(root->children[0]), command);
+    } else { //If no simple command, search for a composed one
+        Object result = evaluateNode(root);
+        //Print an error if no object was created (no command recognized)
+        if (result.type == UNUSED) writeError("Failed to do this operation, please verify it and try again\n");
+        discardObject(result);
+    }
+}
+
+void profileCommand(const char *command) {
+    Profile profile = startProfile();
+    Node *root = parseCommand(command, 1);
+    double parseSeconds = wallTime() - profile.wallStart;
+    executeNode(root, command);
+    freeNode(root);
+    endProfile(profile, parseSeconds);
+}
+
+char isCommandWord(const char *command, const char *word) {
+    int i = 0, j = 0;
+    while (command[i] == ' ') i++;
+    while (word[j] && command[i] == word[j]) i++, j++;
+    while (command[i] == ' ') i++;
+    return !word[j] && !command[i];
+}
+
+char isCommandCall(const char *command, const char *word, const char *argument) {
+    int i = 0, j = 0, k = 0;
+    while (command[i] == ' ') i++;
+    while (word[j] && command[i] == word[j]) i++, j++;
+    if (word[j] || command[i++] != '(') return 0;
+    if (!argument) { //Any argument, the parenthesis opened after the word must be the last one closed
+        for (int depth = 1; depth > 0; i++) {
+            if (!command[i]) return 0;
+            depth += (command[i] == '(') - (command[i] == ')');
+        }
+    } else {
+        while (command[i] == ' ') i++;
+        while (argument[k] && command[i] == argument[k]) i++, k++;
+        while (command[i] == ' ') i++;
+        if (argument[k] || command[i++] != ')') return 0;
+    }
+    while (command[i] == ' ') i++;
+    return !command[i];
+}
+
+char isSimpleCommand(const char *command) {
+    return isCommandCall(command, "profile", NULL) ||
+           isCommandCall(command, "traceEvents", NULL) || containString(command, "help") || containString(command, "displayAll") || containString(command, "clear") || isCommandWord(command, "showPlans") ||
+           isCommandWord(command, "poolStats") || isCommandWord(command, "memstats") || isCommandCall(command, "memstats", "reset") || (containString(command, "readScript") && containCharInOrder(command, "readScript()")) ||
+           isCommandCall(command, "precision", NULL) || isCommandCall(command, "displayLimit", NULL);
+}
+
 void executeCommand(const char *command) {
+    if (!commandArena.depth) trackCommand(command); //The commands of a script are counted with it
+    //The temporaries of the command are freed at once at its end, only the registered objects are kept
+    ArenaMark mark = markArena();
     //Apply simple command that doesn't need processing
-    if (containString(command, "help")) { //Display help file
-        printFileContent("help.txt", stdout); printf("\n\n");
+    if (isCommandCall(command, "profile", NULL)) {
+        char *operation = extractBetweenChar(command, '(', ')');
+        if (isCommandWord(operation, "")) writeError("profile needs an operation to profile, like profile(inv(A))\n"); //Only spaces
+        else profileCommand(operation);
+        free(operation);
+    } else if (isCommandCall(command, "traceEvents", NULL)) {
+        char *link = extractBetweenChar(command, '(', ')');
+        if (isCommandWord(link, "")) { //Only spaces
+            writeError("traceEvents needs the link of the trace file, or off to stop the trace\n");
+        } else {
+            //A running trace is written before the next one starts
+            if (stopTrace() < 0 && !shorterString(link, "off")) writeText("No trace is recorded\n");
+            if (shorterString(link, "off")) {
+                if (startTrace(link)) writeFormat("The events are traced until traceEvents(off), then written in %s\n", link);
+                else writeError("Couldn't write a trace in %s\n", link);
+            }
+        }
+        free(link);
+    } else if (containString(command, "help")) { //Display help file
+        flushOutput();
+        printFileContent("help.txt", stdout); writeText("\n\n");
     } else if (containString(command, "displayAll")) {
         printRegister(mainRegister);
     } else if (containString(command, "clear")) {
         freeRegisterContent(mainRegister);
-        printf("The register was cleared\n");
+        writeText("The register was cleared\n");
+    } else if (isCommandWord(command, "showPlans")) {
+        showPlans = !showPlans;
+        writeFormat("Product plans are %s\n", showPlans ? "displayed" : "hidden");
+    } else if (isCommandWord(command, "poolStats")) {
+        printPoolStatistics();
+    } else if (isCommandCall(command, "memstats", "reset")) {
+        resetAllocationStatistics();
+    } else if (isCommandWord(command, "memstats")) {
+        printAllocationStatistics();
     } else if (containString(command, "readScript") && containCharInOrder(command, "readScript()")) {
         char *fileLink = extractBetweenChar(command, '(', ')');
         readScriptFile(fileLink);
-    } else if (containString(command, "display") && containCharInOrder(command, "display()")) {
-        Object result = checkObject(recursiveCommandDecomposition(extractBetweenChar(command, '(', ')')));
-        if (result.type == UNUSED) fprintf(stderr, "Couldn't calculate %s\n", command);
-        else if (result.type == POLYNOMIAL) printPolynomial(result.any.polynomial);
-        else if (result.type == MATRIX) printMatrix(result.any.matrix);
-        else printVariable(result.any.variable);
-    } else if (containString(command, "eigValues") && containCharInOrder(command, "eigValues()")) { //Eigen values
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == MATRIX) printSolutions(eigenValues(result.any.matrix));
-    } else if (containString(command, "solve") && containCharInOrder(command, "solve()")) { //Solve polynomial or matrix
-        Object result = recursiveCommandDecomposition(extractBetweenChar(command, '(', ')'));
-        if (result.type == POLYNOMIAL) printSolutions(solve(result.any.polynomial));
-        else if (result.type == MATRIX) printMatrix(solveAugmentedMatrix(result.any.matrix));
-    } else { //If no simple command, search for a composed one
-        Object result = recursiveCommandDecomposition(command);
-        //Print an error if no object was created (no command recognized)
-        if (result.type == UNUSED) fprintf(stderr, "Failed to do this operation, please verify it and try again\n");
+        free(fileLink);
+    } else if (isCommandCall(command, "precision", NULL)) {
+        char *setting = extractBetweenChar(command, '(', ')');
+        if (!setOutputPrecision(setting)) writeError("The precision must be a number of digits up to %d, shortest or default\n", OUTPUT_MAX_PRECISION);
+        else if (outputPrecision == OUTPUT_SHORTEST_PRECISION) writeText("Numbers are displayed with the fewest digits that keep their value\n");
+        else if (outputPrecision == OUTPUT_DEFAULT_PRECISION) writeText("Numbers are displayed with their default precision\n");
+        else writeFormat("Numbers are displayed with %d digits after the point\n", outputPrecision);
+        free(setting);
+    } else if (isCommandCall(command, "displayLimit", NULL)) {
+        char *setting = extractBetweenChar(command, '(', ')');
+        if (!setOutputLimit(setting)) writeError("The limit must be a number of rows of at least 2, 0 or full\n");
+        else if (outputLimit) writeFormat("Matrices are displayed up to %d rows and columns\n", outputLimit);
+        else writeText("Matrices are displayed in full\n");
+        free(setting);
+    } else {
+        char traced = traceBegin("phase", "parse", -1);
+        Node *root = parseCommand(command, 1);
+        traceEnd(traced);
+        traced = traceBegin("phase", "evaluate", -1);
+        executeNode(root, command);
+        traceEnd(traced);
+        freeNode(root);
+    }
+    releaseArena(mark);
+    if (!commandArena.depth) releaseSubexpressions();
+    flushOutput();
+}
+
+char isExitCommand(const char *command) {
+    return isCommandWord(command, "exit");
+}
+
+void readCommands(FILE *stream) {
+    //Commands are read in the buffer of the reader, they stay there until the next one is read
+    LineReader reader = newLineReader(stream);
+    char *command = readLine(&reader);
+    while (command && !isExitCommand(command)) {
+        //If no known operation were detected, nothing should happen
+        executeCommand(command);
+        command = readLine(&reader);
+    }
+    freeLineReader(&reader);
+}
+
+/**
+ * Display the arguments of the program
+ * @param output - Stream of the usage
+ * @param program - Name of the program
+ */
+void printUsage(FILE *output, const char *program) {
+    fprintf(output, "Usage: %s [--quiet] [-e <command>]... [-f <script>]... [-]\n"
+                    "Without arguments the commands are typed after a prompt, until exit\n"
+                    "  -e <command>  Apply a command\n"
+                    "  -f <script>   Apply a script, like readScript\n"
+                    "  -             Apply the commands of the standard input until its end, the default without -e and -f\n"
+                    "  -q, --quiet   Hide the status messages (added objects, imported rows)\n"
+                    "The exit code is 1 if a command displayed an error, 2 if the arguments aren't valid\n", program);
+}
+
+int runBatch(int argc, char **argv) {
+    //The arguments are all checked before the first command is applied
+    char readInput = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!shorterString(argv[i], "-h") || !shorterString(argv[i], "--help")) {
+            printUsage(stdout, argv[0]);
+            return EXIT_SUCCESS;
+        } else if ((!shorterString(argv[i], "-e") || !shorterString(argv[i], "-f")) && i + 1 < argc) {
+            readInput = 0;
+            i++;
+        } else if (!shorterString(argv[i], "-q") || !shorterString(argv[i], "--quiet")) {
+            outputQuiet = 1;
+        } else if (shorterString(argv[i], "-")) {
+            printUsage(stderr, argv[0]);
+            return EXIT_INVALID_ARGUMENTS;
+        }
+    }
+    char ended = 0;
+    for (int i = 1; i < argc && !ended; i++) {
+        if (!shorterString(argv[i], "-e")) {
+            ended = isExitCommand(argv[++i]);
+            if (!ended) executeCommand(argv[i]);
+        } else if (!shorterString(argv[i], "-f")) {
+            trackCommand(argv[++i]);
+            readScriptFile(argv[i]);
+            flushOutput();
+        } else if (!shorterString(argv[i], "-")) {
+            readCommands(stdin);
+            readInput = 0;
+        }
     }
+    if (readInput && !ended) readCommands(stdin);
+    if (stopTrace() >= 0) flushOutput(); //The trace is written even if it wasn't stopped
+    return outputErrors ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
+#ifndef LINEARALGEBRA_NO_MAIN
 /**
  * Main function
  * the main function is the first function to launch upon starting the program, it makes the link between all the components of the program
+ * @param argc - Number of arguments
+ * @param argv - Arguments, the program is interactive without them, see runBatch otherwise
  * @return an integer confirming the success or failure of program end
  */
-int main() {
-    printf("Please enter a command or help to see the possibilities\n");
-    char *command = readString(stdin);
+int main(int argc, char **argv) {
+    if (argc > 1) return runBatch(argc, argv);
+    writeText("Please enter a command or help to see the possibilities\n");
+    flushOutput();
+    readCommands(stdin);
+    if (stopTrace() >= 0) flushOutput(); //The trace is written even if it wasn't stopped
 
-    do {
-        //If no known operation were detected, nothing should happen
-        executeCommand(command);
-        //Re-Initialise the command string
-        if (command) free(command);
-        command = readString(stdin);
-    } while (command && !containString(command, "exit"));
-    
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -6,19 +6,18 @@
 #ifndef LINEARALGEBRA_MAIN_H
 #define LINEARALGEBRA_MAIN_H
 
-#include "register.h"
+#include "bytecode.h"
+#include "subexpression.h"
+#include "matrixFile.h"
+#include "importer.h"
+
+#define EXIT_INVALID_ARGUMENTS 2 ///Exit code of the program when its arguments aren't valid
+
+extern Register *mainRegister; ///Global register, all objects are stored here
 
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 // Commands interactions
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-/**
- * Read a matrix in a string
- * This function read a matrix in a string given a specific format and return a matrix structure made from it
- * @param string - String to scan for a matrix
- * @return matrix formed from the string
- */
-Matrix readMatrixInString(const char *string);
-
 /**
  * Eigen values of a matrix
  * This function return the eigen values of a given matrix
@@ -45,7 +44,7 @@ Matrix triangularise(Matrix M);
 
 /**
  * Read and apply a script file
- * This function read a given file and apply the commands in it line by line
+ * This function compile a given file (or load its cached compiled form) and run it, see bytecode.h
  * @param link - link of the file in string format
  */
 void readScriptFile(const char *link);
@@ -61,21 +60,136 @@ void readScriptFile(const char *link);
 Object applyOperation(Object leftOperand, char operator, Object rightOperand);
 
 /**
- * Get a basic object from a string
- * This function recuperate a basic object (existing or created)
- * @param command - object in string format
- * @return object containing the object
+ * Verify if an object is a matrix
+ * @param object - The object to check
+ * @return 1 if the object is a matrix or a deferred matrix expression
+ */
+char isMatrixObject(Object object);
+
+/**
+ * Expression of a matrix object
+ * @param object - A matrix or a deferred matrix expression
+ * @return the expression, a leaf if the object is a matrix
+ */
+Expression *toExpression(Object object);
+
+/**
+ * Calculate a deferred object
+ * This function calculate the matrix of a deferred matrix expression, other objects are returned as they are
+ * @param object - The object to calculate
+ * @return calculated object
+ */
+Object materializeObject(Object object);
+
+/**
+ * Discard a result
+ * This function free a deferred matrix expression whose result isn't needed
+ * @param object - The discarded object
+ */
+void discardObject(Object object);
+
+/**
+ * Apply a function
+ * This function apply a function of the command language (see parser.h) to already calculated arguments
+ * @param function - Index of the function
+ * @param arguments - Arguments of the function
+ * @param nbArguments - Number of arguments
+ * @return object containing the result, an unused object if the arguments don't fit the function
+ */
+Object applyFunction(int function, Object *arguments, int nbArguments);
+
+/**
+ * Opposite of an object
+ * @param operand - The object
+ * @return opposite of the object, an unused object if it can't be calculated
+ */
+Object applyNegation(Object operand);
+
+/**
+ * Save an object in a file
+ * @param object - The object to save, it must be a matrix
+ * @param link - Link of the file, the NumPy format is used if it ends with .npy
+ */
+void saveObject(Object object, const char *link);
+
+/**
+ * Build a matrix from its cells
+ * @param cells - Cells of the matrix in row-major order, they must be variables
+ * @param rows - Number of rows
+ * @param columns - Number of columns
+ * @return object containing the matrix, an unused object if a cell isn't a variable
+ */
+Object buildMatrix(Object *cells, int rows, int columns);
+
+/**
+ * Evaluate a syntax tree
+ * This function calculate the result of a syntax tree by evaluating its children first and combining them. The values
+ * of the matrix literals are moved in the result, a tree can only be evaluated once
+ * @param node - Root of the syntax tree
+ * @return object containing the result of the tree
  */
-Object extractObject(const char *command);
+Object evaluateNode(Node *node);
 
 /**
- * Apply a composite command recursively
- * This function apply a command by reducing to basic object and combining them
+ * Apply a composite command
+ * This function parse a command once in a syntax tree and evaluate it
  * @param command - command in string form
  * @return object containing the result of the command
  */
 Object recursiveCommandDecomposition(const char *command);
 
+/**
+ * Apply a final function
+ * This function apply a function that display its result instead of returning it
+ * @param function - Index of the function, lower than NB_FINAL_FUNCTIONS
+ * @param argument - Argument of the function
+ * @param command - Command containing the call, used in error messages
+ */
+void applyFinalFunction(int function, Object argument, const char *command);
+
+/**
+ * Apply a parsed command
+ * This function save, display or evaluate the result of a syntax tree depending on its root
+ * @param root - Root of the syntax tree, NULL if the command isn't valid
+ * @param command - The command, used in error messages
+ */
+void executeNode(Node *root, const char *command);
+
+/**
+ * Profile a composite command
+ * This function apply a command and display the time of its parse and of its evaluation, the time and the estimated
+ * flops of each kernel it calls, the bytes it allocates and the hardware counters when the system gives them
+ * @param command - command in string form
+ */
+void profileCommand(const char *command);
+
+/**
+ * Verify if a command is a single word
+ * This function is used for the simple commands without arguments, so that names containing them stay usable
+ * @param command - The command to check
+ * @param word - The word
+ * @return 1 if the command is the word, with only spaces around it
+ */
+char isCommandWord(const char *command, const char *word);
+
+/**
+ * Verify if a command is a call with a given argument
+ * This function is used for the simple commands with an argument, like memstats(reset) or profile(inv(A))
+ * @param command - The command to check
+ * @param word - Name of the command
+ * @param argument - The argument, NULL for any argument
+ * @return 1 if the command is the word followed by the argument between parentheses, with only spaces around them
+ */
+char isCommandCall(const char *command, const char *word, const char *argument);
+
+/**
+ * Verify if a command is a simple command
+ * This function verify if a command is one of the commands acting on the program (profile, traceEvents, help, displayAll, clear, showPlans, poolStats, memstats, readScript, precision, displayLimit)
+ * @param command - The command to check
+ * @return result of the check
+ */
+char isSimpleCommand(const char *command);
+
 /**
  * Apply any command
  * This function is the first called when reading a command, it can take simple and composite commands, see readme.md for more details
@@ -83,4 +197,28 @@ Object recursiveCommandDecomposition(const char *command);
  */
 void executeCommand(const char *command);
 
+/**
+ * Verify if a command ends the program
+ * @param command - The command to check
+ * @return 1 if the command is exit, with only spaces around it
+ */
+char isExitCommand(const char *command);
+
+/**
+ * Apply the commands of a stream
+ * This function apply each line of a stream until its end or an exit command
+ * @param stream - The stream, stdin for the commands typed in the terminal
+ */
+void readCommands(FILE *stream);
+
+/**
+ * Apply the commands and scripts given as arguments of the program
+ * The commands and scripts are applied in the order of the arguments, without prompt. The standard input is read until
+ * its end when - is given, or when no command or script is given
+ * @param argc - Number of arguments
+ * @param argv - Arguments: --quiet, -e <command>, -f <script>, -
+ * @return EXIT_SUCCESS, EXIT_FAILURE if a command displayed an error, or EXIT_INVALID_ARGUMENTS
+ */
+int runBatch(int argc, char **argv);
+
 #endif //LINEARALGEBRA_MAIN_H
\ No newline at end of file
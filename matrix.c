@@ -6,23 +6,54 @@
  */
 
 #include "matrix.h"
+#include <sys/mman.h>
 
 Matrix newMatrix(int nbRows, int nbColumns) {
     if (nbRows < 1 || nbColumns < 1) return nullMatrix;
     else {
-        Matrix M = {NULL, malloc(nbRows * sizeof(double *)), nbRows, nbColumns};
-        for (int i = 0; i < M.rows; i++) M.values[i] = calloc(M.columns, sizeof(double));
+        Matrix M = {NULL, temporaryMalloc(nbRows * sizeof(double *)), nbRows, nbColumns};
+        for (int i = 0; i < M.rows; i++) M.values[i] = temporaryCalloc(M.columns, sizeof(double));
         return M;
     }
 }
 
 void freeMatrix(Matrix *M) {
     if (M) {
-        for (int i = 0; i < M->rows; i++) free(M->values[i]);
-        free(M->values);
+        if (M->references && --*M->references > 0) return; //Other holders still use the values
+        if (M->mapping) munmap(M->mapping, M->mappingSize);
+        else for (int i = 0; i < M->rows; i++) temporaryFree(M->values[i]);
+        temporaryFree(M->values); free(M->references);
     }
 }
 
+Matrix shareMatrix(Matrix M) {
+    if (!M.values) return M;
+    if (M.references) (*M.references)++;
+    else { //A temporary result gets its first holder
+        M.references = malloc(sizeof(int));
+        *M.references = 1;
+    }
+    return M;
+}
+
+Matrix promoteMatrix(Matrix M) {
+    char temporary = inArena(M.values);
+    for (int i = 0; i < M.rows && !M.mapping && !temporary; i++) temporary = inArena(M.values[i]);
+    if (!temporary) return M;
+    pauseArena();
+    Matrix copy = copyMatrix(M);
+    resumeArena();
+    copy.name = M.name;
+    return copy;
+}
+
+Matrix writableMatrix(Matrix M) {
+    if (!M.references) return M;
+    Matrix copy = copyMatrix(M);
+    copy.name = M.name;
+    return copy;
+}
+
 Matrix copyMatrix(Matrix M) {
     Matrix copy = newMatrix(M.rows, M.columns);
     for (int i = 0; i < M.rows; i++) {
@@ -33,6 +64,20 @@ Matrix copyMatrix(Matrix M) {
     return copy;
 }
 
+double *vectorToArray(Matrix M, int *size) {
+    if (M.rows != 1 && M.columns != 1) return NULL;
+    *size = M.rows * M.columns;
+    double *values = malloc(*size * sizeof(double));
+    for (int i = 0; i < *size; i++) values[i] = M.rows == 1 ? M.values[0][i] : M.values[i][0];
+    return values;
+}
+
+Matrix arrayToVector(const double *values, int size) {
+    Matrix vector = newMatrix(size, 1);
+    for (int i = 0; i < vector.rows; i++) vector.values[i][0] = values[i];
+    return vector;
+}
+
 Matrix removeRow(Matrix M, int rowIndex) {
     Matrix smallerM = newMatrix(M.rows - 1, M.columns);
     for (int i = 0; i < M.rows; i++) {
@@ -93,13 +138,13 @@ Matrix minus(Matrix A, Matrix B) {
 }
 
 Matrix scalarMultiply(Matrix M, double scalar) {
-    Matrix copy = copyMatrix(M);
-    for (int i = 0; i < copy.rows; i++) {
-        for (int j = 0; j < copy.columns; j++) {
-            copy.values[i][j] *= scalar;
+    M = writableMatrix(M);
+    for (int i = 0; i < M.rows; i++) {
+        for (int j = 0; j < M.columns; j++) {
+            M.values[i][j] *= scalar;
         }
     }
-    return copy;
+    return M;
 }
 
 Matrix multiply(Matrix A, Matrix B) {
@@ -114,6 +159,36 @@ Matrix multiply(Matrix A, Matrix B) {
     } else return nullMatrix;
 }
 
+Matrix multiplyTransposed(Matrix A, char transposeA, Matrix B, char transposeB) {
+    int rows = transposeA ? A.columns : A.rows, inner = transposeA ? A.rows : A.columns;
+    int columns = transposeB ? B.rows : B.columns;
+    if (inner != (transposeB ? B.columns : B.rows)) return nullMatrix;
+    Matrix C = newMatrix(rows, columns);
+    if (!transposeA && transposeB) { //Rows of A by rows of B
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < columns; j++) {
+                double total = 0;
+                for (int k = 0; k < inner; k++) total += A.values[i][k] * B.values[j][k];
+                C.values[i][j] = total;
+            }
+        }
+    } else if (!transposeB) { //Rows of C accumulate rows of B
+        for (int k = 0; k < inner; k++) {
+            for (int i = 0; i < rows; i++) {
+                double factor = transposeA ? A.values[k][i] : A.values[i][k];
+                if (factor != 0) for (int j = 0; j < columns; j++) C.values[i][j] += factor * B.values[k][j];
+            }
+        }
+    } else { //Both transposed
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < columns; j++) {
+                for (int k = 0; k < inner; k++) C.values[i][j] += A.values[k][i] * B.values[j][k];
+            }
+        }
+    }
+    return C;
+}
+
 Matrix transpose(Matrix M) {
     Matrix transpose = newMatrix(M.columns, M.rows);
     for (int i = 0; i < M.rows; i++) {
@@ -123,11 +198,20 @@ Matrix transpose(Matrix M) {
 }
 
 void printMatrix(Matrix M) {
-    if (M.name) printf("%s =\n", M.name);
-    for (int i = 0; i < M.rows; i++) {
-        printf("\t");
-        for (int j = 0; j < M.columns; j++) printf("%1.1lf\t", M.values[i][j]);
-        printf("\n");
+    if (M.name) writeFormat("%s =\n", M.name);
+    //Only the first and the last rows and columns of a large matrix are displayed
+    int rows = outputLimit && M.rows > outputLimit ? outputLimit : M.rows;
+    int columns = outputLimit && M.columns > outputLimit ? outputLimit : M.columns;
+    for (int i = 0; i < rows; i++) {
+        if (rows < M.rows && i == (rows + 1) / 2) writeFormat("\t... %d more row%s ...\n", M.rows - rows, M.rows - rows > 1 ? "s" : "");
+        int row = i < (rows + 1) / 2 ? i : M.rows - rows + i;
+        writeText("\t");
+        for (int j = 0; j < columns; j++) {
+            if (columns < M.columns && j == (columns + 1) / 2) writeText("...\t");
+            writeNumber(M.values[row][j < (columns + 1) / 2 ? j : M.columns - columns + j], 1);
+            writeText("\t");
+        }
+        writeText("\n");
     }
 }
 
@@ -156,12 +240,12 @@ double det(Matrix M) {
 Matrix adjugate(Matrix M) {
     Matrix adjM = newMatrix(M.rows, M.columns);
     if (M.rows == M.columns) {
-        if (M.rows == 1) adjM.values[0][0] = M.values[0][0];
+        if (M.rows == 1) adjM.values[0][0] = 1;
         else {
-            for (int i = 0, sign = 1; i < M.rows; i++) {
-                for (int j = 0; j < M.columns; j++, sign *= -1) {
+            for (int i = 0; i < M.rows; i++) {
+                for (int j = 0; j < M.columns; j++) {
                     Matrix coFactor = removeRow(removeColumn(M, j), i);
-                    adjM.values[i][j] = sign * det(coFactor);
+                    adjM.values[i][j] = ((i + j) % 2 ? -1 : 1) * det(coFactor);
                     freeMatrix(&coFactor);
                 }
             }
@@ -192,13 +276,15 @@ char isColumnEmpty(Matrix M, int index) {
 }
 
 Matrix swapRows(Matrix M, int firstIndex, int secondIndex) {
-    Matrix swapped = copyMatrix(M);
-    for (int i = 0; i < M.columns; i++) swapped.values[firstIndex][i] = M.values[secondIndex][i];
-    for (int i = 0; i < M.columns; i++) swapped.values[secondIndex][i] = M.values[firstIndex][i];
-    return swapped;
+    M = writableMatrix(M);
+    double *row = M.values[firstIndex];
+    M.values[firstIndex] = M.values[secondIndex];
+    M.values[secondIndex] = row;
+    return M;
 }
 
 Matrix solveAugmentedMatrix(Matrix M) {
+    M = writableMatrix(M);
     //Reduce number of rows to be equal or less than the number of columns (square matrix)
     while (M.rows > M.columns - 1) {
         //Remove a null row if there is one, else remove the first
@@ -15,13 +15,16 @@
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 /**
  * @struct Matrix
- * Structure representing a matrix of any size
+ * Structure representing a matrix of any size, its rows are allocated or point in a memory mapped file
  */
 typedef struct {
     char *name;
     double **values; ///Elements of the matrix contained in a 2 dimensional array
     int rows; ///Number of rows of the matrix
     int columns; ///Number of columns matrix
+    void *mapping; ///Memory mapped file the rows point in, NULL if the rows are allocated
+    size_t mappingSize; ///Number of bytes of the mapped file
+    int *references; ///Number of holders sharing the values (register, compiled script), NULL for a temporary result
 } Matrix;
 
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -38,11 +41,37 @@ Matrix newMatrix(int nbRows, int nbColumns);
 
 /**
  * Free an existing matrix
- * This function free an existing matrix and change its pointer to NULL if it worked successfully
+ * This function free an existing matrix and change its pointer to NULL if it worked successfully, the file of a loaded
+ * matrix is unmapped. Shared values are only freed by their last holder
  * @param M - The matrix to free
  */
 void freeMatrix(Matrix *M);
 
+/**
+ * Share a matrix
+ * This function add a holder to the values of a matrix instead of copying them, each holder frees the matrix once
+ * @param M - The matrix to share
+ * @return the matrix with the same values, counting the new holder
+ */
+Matrix shareMatrix(Matrix M);
+
+/**
+ * Keep a matrix after the command
+ * This function copy on the heap a matrix allocated in the arena of the command, other matrices are returned as is
+ * @param M - The matrix to keep
+ * @return matrix whose values outlive the command, with the same name
+ */
+Matrix promoteMatrix(Matrix M);
+
+/**
+ * Prepare a matrix to be modified
+ * This function copy the values of a matrix that have holders before they are modified (copy-on-write), the values
+ * of a temporary result are modified in place
+ * @param M - The matrix to modify
+ * @return matrix whose values can be modified, with the same name
+ */
+Matrix writableMatrix(Matrix M);
+
 /**
  * Remove a row in a matrix
  * This function return a matrix created by removing a row of a given matrix
@@ -89,6 +118,24 @@ Matrix subMat(Matrix M, int r1, int r2, int c1, int c2);
  */
 StringMatrix toStringMatrix(Matrix M);
 
+/**
+ * Transform a vector to an array
+ * This function return the values of a matrix with a single row or a single column
+ * @param M - The vector in matrix form
+ * @param size - Where the number of values is written
+ * @return array of the values of the vector, NULL if M isn't a vector
+ */
+double *vectorToArray(Matrix M, int *size);
+
+/**
+ * Transform an array to a vector
+ * This function create a matrix with a single column containing the given values
+ * @param values - The values of the vector
+ * @param size - Number of values
+ * @return vector in matrix form
+ */
+Matrix arrayToVector(const double *values, int size);
+
 /**
  * Copy a matrix
  * This function returns a copy of a given matrix
@@ -122,7 +169,7 @@ Matrix minus(Matrix A, Matrix B);
 
 /**
  * Multiply a matrix by a scalar
- * This function multiply a matrix by a real scalar
+ * This function multiply a matrix by a real scalar, a temporary matrix is multiplied in place
  * @param M - matrix
  * @param scalar - real scalar
  * @return matrix multiplied by the scalar
@@ -139,6 +186,18 @@ Matrix scalarMultiply(Matrix M, double scalar);
  */
 Matrix multiply(Matrix A, Matrix B);
 
+/**
+ * Matrix multiplication of transposed operands
+ * This function multiply 2 matrices that can be transposed without calculating their transposed, the loops are ordered
+ * so that the rows of the matrices are read contiguously
+ * @param A - the first matrix
+ * @param transposeA - 1 to use the transposed of A
+ * @param B - the second matrix
+ * @param transposeB - 1 to use the transposed of B
+ * @return multiplication of the matrices, null matrix if their sizes don't match
+ */
+Matrix multiplyTransposed(Matrix A, char transposeA, Matrix B, char transposeB);
+
 /**
  * Transpose of a matrix
  * This function return the transpose of a given matrix
@@ -192,7 +251,7 @@ Matrix inverse(Matrix M);
 
 /**
  * Resolution of an augmented matrix
- * This function return the given augmented matrix in a solvable format
+ * This function return the given augmented matrix in a solvable format, a temporary matrix is transformed in place
  * @param M - the given augmented matrix
  * @return Solvable augmented matrix
  */
@@ -0,0 +1,220 @@
+/**
+ * @file matrixFile.c Functions on matrix files
+ * @author Valentin Koeltgen
+ *
+ * This file contain the saving and the loading of matrices in binary files, the loaded files are memory mapped so that
+ * large matrices are usable without being parsed nor copied
+ */
+
+#include "matrixFile.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Verify the extension of a link
+ * @param link - The link to check
+ * @param extension - The extension, with its dot
+ * @return result of the check
+ */
+char hasExtension(const char *link, const char *extension) {
+    int linkLength = length(link), extensionLength = length(extension);
+    return linkLength >= extensionLength && !shorterString(link + linkLength - extensionLength, extension);
+}
+
+/**
+ * Verify the beginning of a text
+ * @param text - The text to check
+ * @param end - End of the text
+ * @param prefix - The expected beginning
+ * @return result of the check
+ */
+char startWith(const char *text, const char *end, const char *prefix) {
+    int i = 0;
+    while (prefix[i] && text + i < end && text[i] == prefix[i]) i++;
+    return !prefix[i];
+}
+
+/**
+ * Write the values of a matrix row by row
+ * @param output - The file to write in
+ * @param M - The matrix to write
+ */
+void writeValues(FILE *output, Matrix M) {
+    for (int i = 0; i < M.rows; i++) fwrite(M.values[i], sizeof(double), M.columns, output);
+}
+
+/**
+ * Save a matrix in the NumPy format
+ * The header is a version 1.0 NumPy header padded with spaces, so that the values are aligned like in files saved by NumPy
+ * @param output - The file to write in
+ * @param M - The matrix to save
+ */
+void saveNpyFile(FILE *output, Matrix M) {
+    char description[128];
+    int size = snprintf(description, sizeof(description), "{'descr': '<f8', 'fortran_order': False, 'shape': (%d, %d), }", M.rows, M.columns);
+    //Magic, version and length of the header take 10 bytes, the header ends with a new line
+    int total = (10 + size + 1 + NPY_ALIGNMENT - 1) / NPY_ALIGNMENT * NPY_ALIGNMENT, headerLength = total - 10;
+    fwrite(NPY_MAGIC, sizeof(char), 6, output);
+    fputc(1, output); fputc(0, output);
+    fputc(headerLength & 0xFF, output); fputc(headerLength >> 8, output);
+    fwrite(description, sizeof(char), size, output);
+    for (int i = 10 + size; i < total - 1; i++) fputc(' ', output);
+    fputc('\n', output);
+    writeValues(output, M);
+}
+
+char saveMatrixFile(Matrix M, const char *link) {
+    if (!M.values) return 0;
+    FILE *output = fopen(link, "wb");
+    if (!output) return 0;
+    if (hasExtension(link, NPY_EXTENSION)) saveNpyFile(output, M);
+    else {
+        MatrixFileHeader header = {MATRIX_FILE_MAGIC, MATRIX_FILE_VERSION, MATRIX_FILE_FLOAT64, MATRIX_FILE_ALIGNMENT, M.rows,
+                                   M.columns, (sizeof(MatrixFileHeader) + MATRIX_FILE_ALIGNMENT - 1) / MATRIX_FILE_ALIGNMENT * MATRIX_FILE_ALIGNMENT};
+        fwrite(&header, sizeof(header), 1, output);
+        for (long long i = sizeof(header); i < header.offset; i++) fputc(0, output);
+        writeValues(output, M);
+    }
+    char written = !ferror(output);
+    return !fclose(output) && written;
+}
+
+/**
+ * Map a whole file in memory
+ * The file is mapped privately: the values can be modified in memory without changing the file
+ * @param link - Link of the file
+ * @param size - Return the number of bytes of the file
+ * @return first byte of the mapped file, NULL if it can't be mapped
+ */
+char *mapFile(const char *link, size_t *size) {
+    int file = open(link, O_RDONLY);
+    if (file < 0) return NULL;
+    struct stat status;
+    char *mapping = NULL;
+    if (!fstat(file, &status) && status.st_size > 0) {
+        *size = (size_t) status.st_size;
+        mapping = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED) mapping = NULL;
+    }
+    //The mapping stays valid once the file is closed
+    close(file);
+    return mapping;
+}
+
+/**
+ * Find a value in the header of a NumPy file
+ * @param header - The header, a Python dictionary
+ * @param end - End of the header
+ * @param key - The key of the value, with its quotes
+ * @return first character of the value, NULL if the key isn't in the header
+ */
+const char *findNpyValue(const char *header, const char *end, const char *key) {
+    for (const char *position = header; position < end; position++) {
+        if (startWith(position, end, key)) {
+            position += length(key);
+            while (position < end && (*position == ' ' || *position == ':')) position++;
+            return position;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Read the header of a NumPy file
+ * Only arrays of little-endian doubles of at most 2 dimensions are accepted, a vector is read as a column
+ * @param file - The mapped file
+ * @param size - Number of bytes of the file
+ * @param rows - Return the number of rows
+ * @param columns - Return the number of columns
+ * @param offset - Return the position of the first value
+ * @param columnMajor - Return 1 if the values are saved column by column
+ * @return 1 if the header was read, 0 otherwise
+ */
+char readNpyHeader(const char *file, size_t size, long long *rows, long long *columns, long long *offset, char *columnMajor) {
+    const unsigned char *bytes = (const unsigned char *) file;
+    long long headerLength, start;
+    if (size >= 10 && bytes[6] == 1) {
+        headerLength = bytes[8] | bytes[9] << 8; start = 10;
+    } else if (size >= 12 && (bytes[6] == 2 || bytes[6] == 3)) {
+        headerLength = bytes[8] | bytes[9] << 8 | bytes[10] << 16 | (long long) bytes[11] << 24; start = 12;
+    } else return 0;
+    *offset = start + headerLength;
+    if ((size_t) *offset > size) return 0;
+    const char *header = file + start, *end = file + *offset;
+    const char *type = findNpyValue(header, end, "'descr'"), *order = findNpyValue(header, end, "'fortran_order'");
+    const char *shape = findNpyValue(header, end, "'shape'");
+    if (!type || !order || !shape || !startWith(type, end, "'<f8'") || shape >= end || *shape != '(') return 0;
+    *columnMajor = startWith(order, end, "True");
+    //Up to 2 dimensions separated by commas, a dimension missing is 1
+    long long dimensions[2] = {1, 1};
+    int nbDimensions = 0;
+    for (shape++; shape < end && *shape != ')'; shape++) {
+        if (*shape >= '0' && *shape <= '9') {
+            if (nbDimensions == 2) return 0;
+            dimensions[nbDimensions] = 0;
+            for (; shape < end && *shape >= '0' && *shape <= '9'; shape++) {
+                if (dimensions[nbDimensions] > INT_MAX) return 0;
+                dimensions[nbDimensions] = dimensions[nbDimensions] * 10 + *shape - '0';
+            }
+            nbDimensions++; shape--;
+        } else if (*shape != ',' && *shape != ' ') return 0;
+    }
+    *rows = dimensions[0]; *columns = dimensions[1];
+    return shape < end;
+}
+
+/**
+ * Create a matrix on mapped values
+ * The rows point directly in the mapped file, values that can't be used in place (column-major or not aligned on a
+ * double) are copied in a new matrix and the file is unmapped
+ * @param mapping - The mapped file
+ * @param size - Number of bytes of the mapped file
+ * @param values - First value in the mapped file
+ * @param rows - Number of rows
+ * @param columns - Number of columns
+ * @param columnMajor - 1 if the values are saved column by column
+ * @return created matrix
+ */
+Matrix mappedMatrix(char *mapping, size_t size, const char *values, int rows, int columns, char columnMajor) {
+    if (!columnMajor && (values - mapping) % sizeof(double) == 0) {
+        Matrix M = {NULL, poolMalloc(rows * sizeof(double *)), rows, columns, mapping, size};
+        for (int i = 0; i < rows; i++) M.values[i] = (double *) values + (size_t) i * columns;
+        return M;
+    }
+    pauseArena(); //Loaded matrices are usually registered, they are allocated on the heap
+    Matrix M = newMatrix(rows, columns);
+    resumeArena();
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < columns; j++) {
+            const char *value = values + sizeof(double) * (columnMajor ? (size_t) j * rows + i : (size_t) i * columns + j);
+            for (int k = 0; k < (int) sizeof(double); k++) ((char *) &M.values[i][j])[k] = value[k];
+        }
+    }
+    munmap(mapping, size);
+    return M;
+}
+
+Matrix loadMatrixFile(const char *link) {
+    size_t size;
+    char *mapping = mapFile(link, &size);
+    if (!mapping) return nullMatrix;
+    long long rows = 0, columns = 0, offset = 0;
+    char columnMajor = 0, valid = 0;
+    //The format is recognized by the first bytes of the file
+    if (startWith(mapping, mapping + size, NPY_MAGIC)) valid = readNpyHeader(mapping, size, &rows, &columns, &offset, &columnMajor);
+    else if (size >= sizeof(MatrixFileHeader) && startWith(mapping, mapping + size, MATRIX_FILE_MAGIC)) {
+        MatrixFileHeader *header = (MatrixFileHeader *) mapping;
+        rows = header->rows; columns = header->columns; offset = header->offset;
+        valid = header->version == MATRIX_FILE_VERSION && header->type == MATRIX_FILE_FLOAT64 && offset >= (long long) sizeof(MatrixFileHeader);
+    }
+    //The file must contain all the values
+    if (valid && rows > 0 && columns > 0 && rows <= INT_MAX && columns <= INT_MAX && (size_t) offset <= size &&
+        (size_t) columns <= (size - offset) / sizeof(double) / rows) {
+        return mappedMatrix(mapping, size, mapping + offset, (int) rows, (int) columns, columnMajor);
+    }
+    munmap(mapping, size);
+    return nullMatrix;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+/**
+ * @file matrixFile.h Header file of matrixFile.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_MATRIXFILE_H
+#define LINEARALGEBRA_MATRIXFILE_H
+
+#include "matrix.h"
+
+#define MATRIX_FILE_MAGIC "LAMX" ///First bytes of a matrix file
+#define MATRIX_FILE_VERSION 1 ///Version of the matrix file format
+#define MATRIX_FILE_FLOAT64 1 ///Type of values: IEEE 754 doubles of 8 bytes, least significant byte first
+#define MATRIX_FILE_ALIGNMENT 64 ///Alignment of the values in a matrix file, the header is padded up to it
+#define NPY_EXTENSION ".npy" ///Extension of the files saved and loaded in the NumPy format
+#define NPY_MAGIC "\x93NUMPY" ///First bytes of a NumPy file
+#define NPY_ALIGNMENT 64 ///Alignment of the values in a saved NumPy file
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct MatrixFileHeader
+ * Structure representing the header of a matrix file, the values follow it row by row from the offset
+ */
+typedef struct {
+    char magic[4]; ///MATRIX_FILE_MAGIC
+    int version; ///MATRIX_FILE_VERSION
+    int type; ///Type of the values
+    int alignment; ///Alignment of the values
+    long long rows; ///Number of rows
+    long long columns; ///Number of columns
+    long long offset; ///Position of the first value in the file, a multiple of the alignment
+} MatrixFileHeader;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Save a matrix in a file
+ * This function write the matrix in the matrix file format, or in the NumPy format if the link ends with .npy
+ * @param M - The matrix to save
+ * @param link - Link of the file to create
+ * @return 1 if the matrix was saved, 0 otherwise
+ */
+char saveMatrixFile(Matrix M, const char *link);
+
+/**
+ * Load a matrix from a file
+ * This function memory map a file in the matrix file format or in the NumPy format, the rows of the matrix point
+ * directly in the mapped file so nothing is read before the values are used. Modified values are only changed in
+ * memory. NumPy files in column-major order are copied
+ * @param link - Link of the file
+ * @return loaded matrix, null matrix if the file can't be read or isn't a matrix of doubles
+ */
+Matrix loadMatrixFile(const char *link);
+
+#endif //LINEARALGEBRA_MATRIXFILE_H
\ No newline at end of file
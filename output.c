@@ -0,0 +1,461 @@
+/**
+ * @file output.c Functions on the output
+ * @author Valentin Koeltgen
+ *
+ * This file contain the buffered display of the results: texts and numbers are formatted in a buffer that is written in
+ * the terminal at once at the end of each command
+ */
+
+#include "output.h"
+#include "stringInteractions.h"
+#include <stdarg.h>
+
+int outputPrecision = OUTPUT_DEFAULT_PRECISION;
+int outputLimit = 0;
+char outputQuiet = 0;
+int outputErrors = 0;
+Output output = {NULL, 0, 0};
+
+/**
+ * Make room in the output buffer
+ * @param size - Number of characters that will be added
+ */
+void reserveOutput(size_t size) {
+    if (output.size + size + 1 <= output.capacity) return;
+    size_t capacity = output.capacity ? output.capacity : OUTPUT_CAPACITY;
+    while (output.size + size + 1 > capacity) capacity *= 2;
+    output.buffer = realloc(output.buffer, capacity);
+    output.capacity = capacity;
+}
+
+/**
+ * Write the output once it is large enough
+ * Big results are written by parts so that the buffer stays small
+ */
+void checkOutputSize() {
+    if (output.size >= OUTPUT_FLUSH_SIZE) flushOutput();
+}
+
+void writeText(const char *text) {
+    size_t size = 0;
+    while (text[size]) size++;
+    reserveOutput(size);
+    for (size_t i = 0; i < size; i++) output.buffer[output.size + i] = text[i];
+    output.size += size;
+    checkOutputSize();
+}
+
+/**
+ * Add a formatted text to the output
+ * @param format - Format of the text, like vprintf
+ * @param values - Values of the format
+ */
+void writeFormatValues(const char *format, va_list values) {
+    va_list copy;
+    va_copy(copy, values);
+    reserveOutput(64);
+    int size = vsnprintf(output.buffer + output.size, output.capacity - output.size, format, values);
+    if (size >= 0 && (size_t) size >= output.capacity - output.size) { //The text was truncated, it is formatted again
+        reserveOutput(size);
+        vsnprintf(output.buffer + output.size, output.capacity - output.size, format, copy);
+    }
+    va_end(copy);
+    if (size < 0) return;
+    output.size += size;
+    checkOutputSize();
+}
+
+void writeFormat(const char *format, ...) {
+    va_list values;
+    va_start(values, format);
+    writeFormatValues(format, values);
+    va_end(values);
+}
+
+void writeStatus(const char *format, ...) {
+    if (outputQuiet) return;
+    va_list values;
+    va_start(values, format);
+    writeFormatValues(format, values);
+    va_end(values);
+}
+
+void writeError(const char *format, ...) {
+    va_list values;
+    va_start(values, format);
+    vfprintf(stderr, format, values);
+    va_end(values);
+    outputErrors++;
+}
+
+/**
+ * Write a positive integer
+ * @param text - Return the digits
+ * @param value - The integer
+ * @param minDigits - Fewest digits, leading zeros are added
+ * @return number of characters written
+ */
+int formatInteger(char *text, unsigned long long value, int minDigits) {
+    char digits[24];
+    int size = 0;
+    do {
+        digits[size++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value || size < minDigits);
+    for (int i = 0; i < size; i++) text[i] = digits[size - 1 - i];
+    return size;
+}
+
+/**
+ * Format a number with a fixed number of digits after the point
+ * The number is rounded like printf when the scaled value isn't too close to halfway between 2 integers, printf is
+ * used otherwise
+ * @param text - Return the formatted number
+ * @param value - The number to format
+ * @param digits - Number of digits after the point
+ * @return number of characters written
+ */
+int formatFixed(char *text, double value, int digits) {
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    char negative = value < 0 || (value == 0 && 1 / value < 0);
+    double absoluteValue = negative ? -value : value;
+    if (digits > 9 || !(absoluteValue < 1e15 / powers[digits])) return snprintf(text, OUTPUT_NUMBER_SIZE, "%1.*lf", digits, value);
+    double scaled = absoluteValue * powers[digits];
+    unsigned long long integer = (unsigned long long) scaled;
+    double fraction = scaled - (double) integer, tolerance = scaled * 1e-15 + 1e-15;
+    if (fraction - 0.5 < tolerance && 0.5 - fraction < tolerance) return snprintf(text, OUTPUT_NUMBER_SIZE, "%1.*lf", digits, value);
+    if (fraction > 0.5) integer++;
+    unsigned long long unit = (unsigned long long) powers[digits];
+    int size = 0;
+    if (negative) text[size++] = '-';
+    size += formatInteger(text + size, integer / unit, 1);
+    if (digits > 0) {
+        text[size++] = '.';
+        size += formatInteger(text + size, integer % unit, digits);
+    }
+    text[size] = '\0';
+    return size;
+}
+
+/**
+ * Write the digits of a number in positional or scientific notation
+ * @param text - Return the formatted number
+ * @param negative - 1 if the number is negative
+ * @param digits - Significant digits, without trailing zeros
+ * @param nbDigits - Number of significant digits
+ * @param exponent - Power of 10 of the first digit
+ * @return number of characters written
+ */
+int writeDigits(char *text, char negative, const char *digits, int nbDigits, int exponent) {
+    int size = 0;
+    if (negative) text[size++] = '-';
+    if (exponent < -4 || exponent >= 17) { //Scientific notation, like printf
+        text[size++] = digits[0];
+        if (nbDigits > 1) text[size++] = '.';
+        for (int i = 1; i < nbDigits; i++) text[size++] = digits[i];
+        text[size++] = 'e'; text[size++] = exponent < 0 ? '-' : '+';
+        size += formatInteger(text + size, exponent < 0 ? -exponent : exponent, 2);
+    } else if (exponent < 0) {
+        text[size++] = '0'; text[size++] = '.';
+        for (int i = -1; i > exponent; i--) text[size++] = '0';
+        for (int i = 0; i < nbDigits; i++) text[size++] = digits[i];
+    } else {
+        for (int i = 0; i <= exponent || i < nbDigits; i++) {
+            if (i == exponent + 1) text[size++] = '.';
+            text[size++] = i < nbDigits ? digits[i] : '0';
+        }
+    }
+    text[size] = '\0';
+    return size;
+}
+
+/**
+ * Set a big integer
+ * @param a - The big integer
+ * @param value - Its new value
+ */
+void setBigInteger(BigInteger *a, unsigned long long value) {
+    a->size = 0;
+    for (; value; value >>= 32) a->words[a->size++] = (unsigned int) value;
+}
+
+/**
+ * Multiply a big integer by a power of 2
+ * @param a - The big integer
+ * @param bits - Power of 2
+ */
+void shiftBigInteger(BigInteger *a, int bits) {
+    if (!a->size) return;
+    int words = bits / 32; bits %= 32;
+    if (bits) { //The last word can overflow in a new one
+        a->words[a->size] = 0;
+        for (int i = a->size; i > 0; i--) a->words[i] = a->words[i] << bits | a->words[i - 1] >> (32 - bits);
+        a->words[0] <<= bits;
+        if (a->words[a->size]) a->size++;
+    }
+    if (words) {
+        for (int i = a->size - 1; i >= 0; i--) a->words[i + words] = a->words[i];
+        for (int i = 0; i < words; i++) a->words[i] = 0;
+        a->size += words;
+    }
+}
+
+/**
+ * Multiply a big integer by a word
+ * @param a - The big integer
+ * @param factor - The word
+ */
+void multiplyBigInteger(BigInteger *a, unsigned int factor) {
+    unsigned long long carry = 0;
+    for (int i = 0; i < a->size; i++) {
+        carry += (unsigned long long) a->words[i] * factor;
+        a->words[i] = (unsigned int) carry;
+        carry >>= 32;
+    }
+    if (carry) a->words[a->size++] = (unsigned int) carry;
+}
+
+/**
+ * Multiply a big integer by a power of 10
+ * @param a - The big integer
+ * @param power - Power of 10
+ */
+void multiplyPowerOf10(BigInteger *a, int power) {
+    for (; power >= 9; power -= 9) multiplyBigInteger(a, 1000000000);
+    static const unsigned int powers[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+    if (power) multiplyBigInteger(a, powers[power]);
+}
+
+/**
+ * Add 2 big integers
+ * @param result - Return the sum
+ * @param a - First big integer
+ * @param b - Second big integer
+ */
+void addBigIntegers(BigInteger *result, const BigInteger *a, const BigInteger *b) {
+    if (a->size < b->size) {
+        const BigInteger *swap = a; a = b; b = swap;
+    }
+    unsigned long long carry = 0;
+    for (int i = 0; i < a->size; i++) {
+        carry += (unsigned long long) a->words[i] + (i < b->size ? b->words[i] : 0);
+        result->words[i] = (unsigned int) carry;
+        carry >>= 32;
+    }
+    result->size = a->size;
+    if (carry) result->words[result->size++] = (unsigned int) carry;
+}
+
+/**
+ * Subtract a big integer from another one
+ * @param a - The big integer, it must not be lower than b
+ * @param b - The big integer to subtract
+ */
+void subtractBigInteger(BigInteger *a, const BigInteger *b) {
+    long long borrow = 0;
+    for (int i = 0; i < a->size; i++) {
+        borrow += (long long) a->words[i] - (i < b->size ? b->words[i] : 0);
+        a->words[i] = (unsigned int) borrow;
+        borrow = borrow < 0 ? -1 : 0;
+    }
+    while (a->size && !a->words[a->size - 1]) a->size--;
+}
+
+/**
+ * Compare 2 big integers
+ * @param a - First big integer
+ * @param b - Second big integer
+ * @return negative if a is lower than b, positive if it is higher, 0 if they are equal
+ */
+int compareBigIntegers(const BigInteger *a, const BigInteger *b) {
+    if (a->size != b->size) return a->size - b->size;
+    for (int i = a->size - 1; i >= 0; i--) {
+        if (a->words[i] != b->words[i]) return a->words[i] < b->words[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * Value of a big integer of at most 4 words
+ * @param a - The big integer
+ * @return its value
+ */
+unsigned __int128 toInt128(const BigInteger *a) {
+    unsigned __int128 value = 0;
+    for (int i = a->size - 1; i >= 0; i--) value = value << 32 | a->words[i];
+    return value;
+}
+
+/**
+ * Generate the shortest digits of a number
+ * Each digit is the integer part of rest * 10 / scale, until the number written is between the halfway points
+ * @param digits - Return the digits
+ * @param rest - The number times scale, it is modified
+ * @param scale - Scale of the number
+ * @param above - Distance to the upper halfway point times scale, it is modified
+ * @param below - Distance to the lower halfway point times scale, it is modified
+ * @param even - 1 if the halfway points read back to the number
+ * @return number of digits
+ */
+int shortestDigits(char *digits, BigInteger *rest, const BigInteger *scale, BigInteger *above, BigInteger *below, char even) {
+    BigInteger sum;
+    int nbDigits = 0;
+    for (char low = 0, high = 0; !low && !high && nbDigits <= OUTPUT_MAX_PRECISION;) {
+        multiplyBigInteger(rest, 10); multiplyBigInteger(above, 10); multiplyBigInteger(below, 10);
+        int digit = 0;
+        for (; compareBigIntegers(rest, scale) >= 0; digit++) subtractBigInteger(rest, scale);
+        addBigIntegers(&sum, rest, above);
+        low = compareBigIntegers(rest, below) < even;
+        high = compareBigIntegers(&sum, scale) >= !even;
+        char up = high;
+        if (low && high) { //Both digits read back to the number, the closest one is kept
+            addBigIntegers(&sum, rest, rest);
+            int comparison = compareBigIntegers(&sum, scale);
+            up = comparison > 0 || (comparison == 0 && digit % 2);
+        }
+        digits[nbDigits++] = (char) ('0' + digit + up);
+    }
+    return nbDigits;
+}
+
+/**
+ * Generate the shortest digits of a number on 128 bits integers
+ * This function is the same as shortestDigits for a scale of at most 96 bits, rest * 10 then fits in 128 bits
+ * @param digits - Return the digits
+ * @param rest - The number times scale
+ * @param scale - Scale of the number
+ * @param above - Distance to the upper halfway point times scale
+ * @param below - Distance to the lower halfway point times scale
+ * @param even - 1 if the halfway points read back to the number
+ * @return number of digits
+ */
+int shortestDigitsInt128(char *digits, unsigned __int128 rest, unsigned __int128 scale, unsigned __int128 above,
+                         unsigned __int128 below, char even) {
+    int nbDigits = 0;
+    for (char low = 0, high = 0; !low && !high && nbDigits <= OUTPUT_MAX_PRECISION;) {
+        rest *= 10; above *= 10; below *= 10;
+        int digit = 0;
+        for (; rest >= scale; digit++) rest -= scale;
+        low = even ? rest <= below : rest < below;
+        high = even ? rest + above >= scale : rest + above > scale;
+        char up = high;
+        if (low && high) up = 2 * rest > scale || (2 * rest == scale && digit % 2); //The closest digit is kept
+        digits[nbDigits++] = (char) ('0' + digit + up);
+    }
+    return nbDigits;
+}
+
+/**
+ * Format a number with the fewest significant digits that read back to the same value
+ * Integers are written directly. Other numbers use the free-format algorithm of Steele, White, Burger and Dybvig: the
+ * number and the halfway points to its neighbours are scaled to exact big integers, the digits are generated until
+ * the number written is between them, its last digit is the closest one to the number
+ * @param text - Return the formatted number
+ * @param value - The number to format
+ * @return number of characters written
+ */
+int formatShortest(char *text, double value) {
+    char negative = value < 0 || (value == 0 && 1 / value < 0);
+    double absoluteValue = negative ? -value : value;
+    if (absoluteValue < 1e15 && (double) (unsigned long long) absoluteValue == absoluteValue) {
+        int size = 0;
+        if (negative) text[size++] = '-';
+        size += formatInteger(text + size, (unsigned long long) absoluteValue, 1);
+        text[size] = '\0';
+        return size;
+    }
+    if (absoluteValue != absoluteValue || absoluteValue > 1.7976931348623157e308) return snprintf(text, OUTPUT_NUMBER_SIZE, "%g", value);
+    //absoluteValue = mantissa * 2^exponent
+    union {double value; unsigned long long bits;} number = {absoluteValue};
+    int biasedExponent = (int) (number.bits >> 52);
+    unsigned long long mantissa = number.bits & ((1ULL << 52) - 1);
+    int exponent = biasedExponent ? biasedExponent - 1075 : -1074;
+    if (biasedExponent) mantissa |= 1ULL << 52;
+    //The numbers reading to an even mantissa include the halfway points, the gap below a power of 2 is twice as small
+    char even = !(mantissa & 1), closerBelow = biasedExponent > 1 && mantissa == 1ULL << 52;
+    //absoluteValue = rest / scale, the halfway points are (rest - below) / scale and (rest + above) / scale
+    BigInteger rest, scale, above, below, sum;
+    setBigInteger(&rest, mantissa); setBigInteger(&scale, 1); setBigInteger(&above, 1); setBigInteger(&below, 1);
+    shiftBigInteger(&rest, closerBelow ? 2 : 1);
+    shiftBigInteger(&scale, closerBelow ? 2 : 1);
+    if (closerBelow) shiftBigInteger(&above, 1);
+    if (exponent >= 0) {
+        shiftBigInteger(&rest, exponent); shiftBigInteger(&above, exponent); shiftBigInteger(&below, exponent);
+    } else shiftBigInteger(&scale, -exponent);
+    //The estimate of the power of 10 of the upper halfway point is exact or one too low
+    int nbBits = 0;
+    while (mantissa >> nbBits) nbBits++;
+    double estimate = (exponent + nbBits - 1) * 0.30102999566398114 - 1e-10;
+    int power = (int) estimate;
+    if (power < estimate) power++;
+    if (power >= 0) multiplyPowerOf10(&scale, power);
+    else {
+        multiplyPowerOf10(&rest, -power); multiplyPowerOf10(&above, -power); multiplyPowerOf10(&below, -power);
+    }
+    addBigIntegers(&sum, &rest, &above);
+    if (compareBigIntegers(&sum, &scale) >= !even) {
+        multiplyBigInteger(&scale, 10);
+        power++;
+    }
+    char digits[OUTPUT_MAX_PRECISION + 1];
+    int nbDigits;
+    if (scale.size <= 3) nbDigits = shortestDigitsInt128(digits, toInt128(&rest), toInt128(&scale), toInt128(&above), toInt128(&below), even);
+    else nbDigits = shortestDigits(digits, &rest, &scale, &above, &below, even);
+    while (nbDigits > 1 && digits[nbDigits - 1] == '0') nbDigits--;
+    return writeDigits(text, negative, digits, nbDigits, power - 1);
+}
+
+int formatNumber(char *text, double value, int digits) {
+    if (outputPrecision == OUTPUT_SHORTEST_PRECISION) return formatShortest(text, value);
+    return formatFixed(text, value, outputPrecision == OUTPUT_DEFAULT_PRECISION ? digits : outputPrecision);
+}
+
+void writeNumber(double value, int digits) {
+    reserveOutput(OUTPUT_NUMBER_SIZE);
+    output.size += formatNumber(output.buffer + output.size, value, digits);
+    checkOutputSize();
+}
+
+void flushOutput() {
+    if (output.size) {
+        fwrite(output.buffer, sizeof(char), output.size, stdout);
+        output.size = 0;
+    }
+    fflush(stdout);
+}
+
+/**
+ * Read a setting made of digits
+ * @param setting - The setting
+ * @param value - Return the read value
+ * @return 1 if the setting is a positive integer, 0 otherwise
+ */
+char readSettingValue(const char *setting, int *value) {
+    int i = 0;
+    *value = 0;
+    while (setting[i] == ' ') i++;
+    if (setting[i] < '0' || setting[i] > '9') return 0;
+    for (; setting[i] >= '0' && setting[i] <= '9'; i++) {
+        if (*value > 100000000) return 0;
+        *value = *value * 10 + setting[i] - '0';
+    }
+    while (setting[i] == ' ') i++;
+    return !setting[i];
+}
+
+char setOutputPrecision(const char *setting) {
+    int value;
+    if (containString(setting, "shortest")) outputPrecision = OUTPUT_SHORTEST_PRECISION;
+    else if (containString(setting, "default")) outputPrecision = OUTPUT_DEFAULT_PRECISION;
+    else if (readSettingValue(setting, &value) && value <= OUTPUT_MAX_PRECISION) outputPrecision = value;
+    else return 0;
+    return 1;
+}
+
+char setOutputLimit(const char *setting) {
+    int value;
+    if (containString(setting, "full")) outputLimit = 0;
+    else if (readSettingValue(setting, &value) && value != 1) outputLimit = value;
+    else return 0;
+    return 1;
+}
\ No newline at end of file
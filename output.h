@@ -0,0 +1,119 @@
+/**
+ * @file output.h Header file of output.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_OUTPUT_H
+#define LINEARALGEBRA_OUTPUT_H
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#define OUTPUT_CAPACITY (1 << 16) ///Initial size of the output buffer
+#define OUTPUT_FLUSH_SIZE (1 << 22) ///Number of buffered characters written at once before the end of a command
+#define OUTPUT_DEFAULT_PRECISION (-2) ///Precision of the numbers chosen by each display (1 digit for matrices and polynomials)
+#define OUTPUT_SHORTEST_PRECISION (-1) ///Precision of the numbers written with the fewest digits that read back to the same value
+#define OUTPUT_MAX_PRECISION 17 ///Most digits after the point of a number
+#define OUTPUT_NUMBER_SIZE 352 ///Most characters of a formatted number, the largest doubles have 309 digits before the point
+#define OUTPUT_BIG_WORDS 40 ///Number of 32 bits words of the integers of the shortest format, the smallest doubles scaled need 1132 bits
+
+extern int outputPrecision; ///Number of digits after the point of the displayed numbers, or one of the precisions above
+extern int outputLimit; ///Most rows and columns of a displayed matrix, the middle ones are abbreviated, 0 to display them all
+extern char outputQuiet; ///1 to hide the status messages of the commands (added objects, imported rows)
+extern int outputErrors; ///Number of errors displayed since the start
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct Output
+ * Structure representing the text displayed by a command, it is formatted in a buffer and written at once
+ */
+typedef struct {
+    char *buffer; ///Characters not written yet
+    size_t size; ///Number of characters in the buffer
+    size_t capacity; ///Size of the buffer, it doubles when a text doesn't fit
+} Output;
+
+/**
+ * @struct BigInteger
+ * Structure representing a non-negative integer of the shortest format, a double and its rounding bounds are scaled to them
+ */
+typedef struct {
+    int size; ///Number of used words, 0 for 0
+    unsigned int words[OUTPUT_BIG_WORDS]; ///Words of the integer, the lowest first
+} BigInteger;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Add a text to the output
+ * @param text - The text to add
+ */
+void writeText(const char *text);
+
+/**
+ * Add a formatted text to the output
+ * @param format - Format of the text, like printf
+ * @param ... - Values of the format
+ */
+void writeFormat(const char *format, ...);
+
+/**
+ * Add a formatted status message to the output
+ * Status messages tell what a command did besides its result, they are hidden when the output is quiet
+ * @param format - Format of the message, like printf
+ * @param ... - Values of the format
+ */
+void writeStatus(const char *format, ...);
+
+/**
+ * Display a formatted error
+ * The error is written at once on the error output, before the output of the command, and counted in outputErrors
+ * @param format - Format of the error, like printf
+ * @param ... - Values of the format
+ */
+void writeError(const char *format, ...);
+
+/**
+ * Format a number
+ * With the default precision the number is written with the given number of digits after the point, like "%1.*lf".
+ * With the shortest precision the number is written with the fewest significant digits that read back to the same value
+ * @param text - Return the formatted number, at least OUTPUT_NUMBER_SIZE characters long
+ * @param value - The number to format
+ * @param digits - Number of digits after the point used by the default precision
+ * @return number of characters written
+ */
+int formatNumber(char *text, double value, int digits);
+
+/**
+ * Add a number to the output
+ * @param value - The number to add
+ * @param digits - Number of digits after the point used by the default precision
+ */
+void writeNumber(double value, int digits);
+
+/**
+ * Write the output in the terminal
+ * The whole buffer is given to a single fwrite then emptied
+ */
+void flushOutput();
+
+/**
+ * Change the precision of the displayed numbers
+ * @param setting - Number of digits after the point, "shortest" or "default"
+ * @return 1 if the precision was changed, 0 if the setting isn't valid
+ */
+char setOutputPrecision(const char *setting);
+
+/**
+ * Change the most rows and columns of a displayed matrix
+ * @param setting - The limit, at least 2, or 0 or "full" to display the matrices entirely
+ * @return 1 if the limit was changed, 0 if the setting isn't valid
+ */
+char setOutputLimit(const char *setting);
+
+#include "tracking.h"
+
+#endif //LINEARALGEBRA_OUTPUT_H
\ No newline at end of file
@@ -0,0 +1,369 @@
+/**
+ * @file parser.c Functions on commands
+ * @author Valentin Koeltgen
+ *
+ * This file contain the lexer and the parser transforming a command into a syntax tree
+ */
+
+#include "parser.h"
+
+///Names of the functions, in the order of their index
+const char *functionNames[NB_FUNCTIONS] = {"display", "eigValues", "solve", "squareFree", "save", "triangularise", "trans", "adj", "inv", "eigVectors", "PLambda", "derive", "trace", "det", "interp", "evaluate", "gcd", "compose", "shift", "load", "import"};
+
+Lexer newLexer(const char *string) {
+    Lexer lexer = {string, 0};
+    nextToken(&lexer);
+    return lexer;
+}
+
+/**
+ * Verify if a character can be part of a name
+ * @param character - The character to check
+ * @return result of the check
+ */
+char isNameCharacter(char character) {
+    return character > ' ' && character <= '~' && character != '+' && character != '-' && character != '*' && character != '/' &&
+           character != '(' && character != ')' && character != '[' && character != ']' && character != ',' && character != ';' &&
+           character != '=' && character != '^' && character != '"';
+}
+
+/**
+ * Read the power of a polynomial term
+ * This function read "X" or "X^<power>" at the current position of the lexer
+ * @param lexer - The lexer, positioned on the X
+ * @param token - The term token to complete
+ * @return 1 if a term was read, 0 if the X is the beginning of a name
+ */
+char readTerm(Lexer *lexer, Token *token) {
+    const char *string = lexer->string;
+    int position = lexer->position + 1;
+    token->power = 1;
+    if (string[position] == '^') {
+        if (string[position + 1] < '0' || string[position + 1] > '9') return 0;
+        token->power = 0;
+        for (position++; string[position] >= '0' && string[position] <= '9'; position++) token->power = token->power * 10 + string[position] - '0';
+    } else if (isNameCharacter(string[position])) return 0;
+    token->type = TOKEN_TERM;
+    lexer->position = position;
+    return 1;
+}
+
+void nextToken(Lexer *lexer) {
+    const char *string = lexer->string;
+    while (string[lexer->position] == ' ' || string[lexer->position] == '\t') lexer->position++;
+    Token token = {TOKEN_END, string + lexer->position, 0, 1, 0};
+    char character = string[lexer->position];
+    if (!character) {
+        lexer->current = token; return;
+    }
+    if ((character >= '0' && character <= '9') || character == '.') { //Number, possibly followed by X
+        int size;
+        token.type = TOKEN_NUMBER;
+        token.value = parseDouble(string + lexer->position, &size);
+        if (!size) { //A single '.'
+            token.type = TOKEN_ERROR; size = 1;
+        }
+        lexer->position += size;
+        if (token.type == TOKEN_NUMBER && string[lexer->position] == 'X' && !readTerm(lexer, &token)) token.type = TOKEN_ERROR;
+    } else if (character == '"') { //String, up to the next "
+        token.type = TOKEN_STRING;
+        for (lexer->position++; string[lexer->position] && string[lexer->position] != '"'; lexer->position++);
+        if (string[lexer->position]) lexer->position++;
+        else token.type = TOKEN_ERROR;
+    } else if (character == 'X' && readTerm(lexer, &token)) { //Term with an implicit coefficient of 1
+    } else if (isNameCharacter(character)) {
+        token.type = TOKEN_NAME;
+        while (isNameCharacter(string[lexer->position])) lexer->position++;
+    } else {
+        lexer->position++;
+        if (character == '+' || character == '-' || character == '*' || character == '/') token.type = TOKEN_OPERATOR;
+        else if (character == '(') token.type = TOKEN_LEFT_PARENTHESIS;
+        else if (character == ')') token.type = TOKEN_RIGHT_PARENTHESIS;
+        else if (character == '[') token.type = TOKEN_LEFT_BRACKET;
+        else if (character == ']') token.type = TOKEN_RIGHT_BRACKET;
+        else if (character == ',') token.type = TOKEN_COMMA;
+        else if (character == ';') token.type = TOKEN_SEMICOLON;
+        else if (character == '=') token.type = TOKEN_EQUAL;
+        else token.type = TOKEN_ERROR;
+    }
+    token.length = (int) (string + lexer->position - token.start);
+    lexer->current = token;
+}
+
+int functionIndex(const char *name, int length) {
+    for (int i = 0; i < NB_FUNCTIONS; i++) {
+        int j = 0;
+        while (j < length && functionNames[i][j] && functionNames[i][j] == name[j]) j++;
+        if (j == length && !functionNames[i][j]) return i;
+    }
+    return FUNCTION_UNKNOWN;
+}
+
+/**
+ * Create a node
+ * @param type - Type of the node
+ * @param nbChildren - Number of children of the node
+ * @return created node
+ */
+Node *newNode(char type, int nbChildren) {
+    Node *node = temporaryCalloc(1, sizeof(Node));
+    node->type = type;
+    node->nbChildren = nbChildren;
+    if (nbChildren > 0) node->children = temporaryCalloc(nbChildren, sizeof(Node *));
+    return node;
+}
+
+/**
+ * Add a child to a node
+ * @param node - The parent node
+ * @param child - The child to add
+ */
+void addChild(Node *node, Node *child) {
+    //The capacity doubles when it is full, it is full when the number of children is a power of 2
+    if ((node->nbChildren & (node->nbChildren - 1)) == 0) {
+        node->children = temporaryRealloc(node->children, (node->nbChildren ? 2 * node->nbChildren : 1) * sizeof(Node *));
+    }
+    node->children[node->nbChildren++] = child;
+}
+
+void freeNode(Node *node) {
+    if (node) {
+        for (int i = 0; i < node->nbChildren; i++) freeNode(node->children[i]);
+        temporaryFree(node->children);
+        temporaryFree(node->name);
+        freeMatrix(&node->matrix);
+        temporaryFree(node);
+    }
+}
+
+Node *parseExpression(Lexer *lexer, int minPrecedence);
+
+/**
+ * Skip the blanks of a command
+ * @param string - The command
+ * @param position - Index of the first character to check, it is moved after the blanks
+ */
+void skipBlanks(const char *string, int *position) {
+    while (string[*position] == ' ' || string[*position] == '\t') (*position)++;
+}
+
+/**
+ * Parse a matrix literal only made of numbers
+ * This function count the separators of the literal to create its matrix, then read its numbers directly in the matrix
+ * without creating a node for each cell. The lexer being positioned after the [, it is moved after the ] if the
+ * literal was read
+ * @param lexer - The lexer
+ * @return matrix node, NULL if the literal contain something else than numbers or isn't valid
+ */
+Node *parseConstantMatrix(Lexer *lexer) {
+    const char *string = lexer->string;
+    int position = lexer->position, nbColumns = 1, nbRows = 1;
+    char blankRow = 0;
+    //The size is known from the separators of the first row and the number of rows
+    for (; string[position] != ']'; position++) {
+        char character = string[position];
+        if (character == ',' && nbRows == 1) nbColumns++;
+        else if (character == ';') nbRows++;
+        else if (!(character >= '0' && character <= '9') && character != '.' && character != 'e' && character != 'E' &&
+                 character != '+' && character != '-' && character != ',' && character != ' ' && character != '\t') return NULL;
+        if (character == ';') blankRow = 1;
+        else if (character != ' ' && character != '\t') blankRow = 0;
+    }
+    if (blankRow) nbRows--; //The last row doesn't need a ;
+    Matrix M = newMatrix(nbRows, nbColumns);
+    if (!M.values) return NULL;
+    position = lexer->position;
+    for (int i = 0; i < nbRows; i++) {
+        for (int j = 0; j < nbColumns; j++) {
+            int size;
+            skipBlanks(string, &position);
+            M.values[i][j] = parseDouble(string + position, &size);
+            position += size;
+            skipBlanks(string, &position);
+            //Cells are followed by a comma, except the last one of a row
+            char separator = string[position++];
+            if (!size || (j < nbColumns - 1 && separator != ',') || (j == nbColumns - 1 && separator != ';' && separator != ']')) {
+                freeMatrix(&M);
+                return NULL;
+            }
+        }
+        if (i == nbRows - 1 && string[position - 1] == ';') { //Blanks between the last ; and the ]
+            skipBlanks(string, &position);
+            position++;
+        }
+    }
+    Node *matrix = newNode(NODE_MATRIX, 0);
+    matrix->rows = nbRows; matrix->columns = nbColumns; matrix->matrix = M;
+    lexer->position = position;
+    nextToken(lexer);
+    return matrix;
+}
+
+/**
+ * Parse a matrix literal
+ * This function parse the cells of a matrix literal, the lexer being positioned after the [
+ * @param lexer - The lexer
+ * @return matrix node, NULL if the rows don't have the same size
+ */
+Node *parseMatrix(Lexer *lexer) {
+    Node *matrix = newNode(NODE_MATRIX, 0);
+    for (int column = 0;;) {
+        Node *cell = parseExpression(lexer, 1);
+        if (!cell) break;
+        addChild(matrix, cell); column++;
+        if (lexer->current.type == TOKEN_COMMA) nextToken(lexer);
+        else if (lexer->current.type == TOKEN_SEMICOLON || lexer->current.type == TOKEN_RIGHT_BRACKET) {
+            //End of a row, all rows must have the size of the first
+            if (matrix->rows == 0) matrix->columns = column;
+            else if (column != matrix->columns) break;
+            matrix->rows++; column = 0;
+            if (lexer->current.type == TOKEN_SEMICOLON) nextToken(lexer);
+            if (lexer->current.type == TOKEN_RIGHT_BRACKET) { //The last row doesn't need a ;
+                nextToken(lexer);
+                return matrix;
+            }
+        } else break;
+    }
+    freeNode(matrix);
+    return NULL;
+}
+
+/**
+ * Parse a primary expression
+ * This function parse a number, a term, an object, a string, a function call, a matrix or an expression between parenthesis
+ * @param lexer - The lexer
+ * @return node of the expression, NULL if it isn't valid
+ */
+Node *parsePrimary(Lexer *lexer) {
+    Token token = lexer->current;
+    Node *node = NULL;
+    if (token.type == TOKEN_NUMBER || token.type == TOKEN_TERM) {
+        node = newNode(token.type == TOKEN_NUMBER ? NODE_NUMBER : NODE_TERM, 0);
+        node->value = token.value; node->power = token.power;
+        nextToken(lexer);
+    } else if (token.type == TOKEN_NAME) {
+        nextToken(lexer);
+        if (lexer->current.type == TOKEN_LEFT_PARENTHESIS) { //Function call
+            node = newNode(NODE_CALL, 0);
+            node->function = functionIndex(token.start, token.length);
+            nextToken(lexer);
+            if (node->function == FUNCTION_UNKNOWN) {
+                freeNode(node); return NULL;
+            }
+            while (lexer->current.type != TOKEN_RIGHT_PARENTHESIS) {
+                Node *argument = parseExpression(lexer, 1);
+                if (!argument) {
+                    freeNode(node); return NULL;
+                }
+                addChild(node, argument);
+                if (lexer->current.type == TOKEN_COMMA) nextToken(lexer);
+                else if (lexer->current.type != TOKEN_RIGHT_PARENTHESIS) {
+                    freeNode(node); return NULL;
+                }
+            }
+            nextToken(lexer);
+        } else {
+            node = newNode(NODE_NAME, 0);
+            node->name = temporaryString(token.start, token.length);
+        }
+    } else if (token.type == TOKEN_STRING) { //The quotes aren't kept
+        node = newNode(NODE_STRING, 0);
+        node->name = temporaryString(token.start + 1, token.length - 2);
+        nextToken(lexer);
+    } else if (token.type == TOKEN_LEFT_PARENTHESIS) {
+        nextToken(lexer);
+        node = parseExpression(lexer, 1);
+        if (node && lexer->current.type == TOKEN_RIGHT_PARENTHESIS) nextToken(lexer);
+        else {
+            freeNode(node); node = NULL;
+        }
+    } else if (token.type == TOKEN_LEFT_BRACKET) {
+        //Literals only made of numbers are read directly, the others cell by cell
+        node = parseConstantMatrix(lexer);
+        if (!node) {
+            nextToken(lexer);
+            node = parseMatrix(lexer);
+        }
+    }
+    return node;
+}
+
+/**
+ * Parse a unary expression
+ * This function parse the signs in front of a primary expression
+ * @param lexer - The lexer
+ * @return node of the expression, NULL if it isn't valid
+ */
+Node *parseUnary(Lexer *lexer) {
+    if (lexer->current.type == TOKEN_OPERATOR && (lexer->current.start[0] == '-' || lexer->current.start[0] == '+')) {
+        char sign = lexer->current.start[0];
+        nextToken(lexer);
+        Node *operand = parseUnary(lexer);
+        if (!operand || sign == '+') return operand;
+        Node *node = newNode(NODE_NEGATE, 1);
+        node->children[0] = operand;
+        return node;
+    }
+    return parsePrimary(lexer);
+}
+
+/**
+ * Precedence of an operator
+ * @param operator - The operator
+ * @return 2 for * and /, 1 for + and -
+ */
+int precedence(char operator) {
+    return operator == '*' || operator == '/' ? 2 : 1;
+}
+
+/**
+ * Parse an expression
+ * This function parse operations by precedence climbing, only operators of at least the given precedence are consumed
+ * @param lexer - The lexer
+ * @param minPrecedence - Lowest precedence of the operators to consume
+ * @return node of the expression, NULL if it isn't valid
+ */
+Node *parseExpression(Lexer *lexer, int minPrecedence) {
+    Node *left = parseUnary(lexer);
+    while (left && lexer->current.type == TOKEN_OPERATOR && precedence(lexer->current.start[0]) >= minPrecedence) {
+        char operator = lexer->current.start[0];
+        nextToken(lexer);
+        //Operators are left associative, the right operand only takes operators of higher precedence
+        Node *right = parseExpression(lexer, precedence(operator) + 1);
+        if (!right) {
+            freeNode(left); return NULL;
+        }
+        Node *operation = newNode(NODE_OPERATION, 2);
+        operation->operator = operator;
+        operation->children[0] = left; operation->children[1] = right;
+        left = operation;
+    }
+    return left;
+}
+
+Node *parseCommand(const char *command, char verbose) {
+    if (!command) return NULL;
+    Lexer lexer = newLexer(command);
+    Node *root;
+    //Assignment "<name> = <operation>"
+    Lexer afterName = lexer;
+    nextToken(&afterName);
+    if (afterName.current.type == TOKEN_EQUAL) {
+        if (lexer.current.type != TOKEN_NAME) {
+            if (verbose && lexer.current.type == TOKEN_TERM) writeError("Error, can't use 'X' as a variable name\n");
+            return NULL;
+        }
+        nextToken(&afterName);
+        Node *value = parseExpression(&afterName, 1);
+        if (!value) return NULL;
+        root = newNode(NODE_ASSIGNMENT, 1);
+        root->name = temporaryString(lexer.current.start, lexer.current.length);
+        root->children[0] = value;
+        lexer = afterName;
+    } else root = parseExpression(&lexer, 1);
+    //The whole command must have been read
+    if (root && lexer.current.type != TOKEN_END) {
+        freeNode(root); root = NULL;
+    }
+    return root;
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+/**
+ * @file parser.h Header file of parser.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_PARSER_H
+#define LINEARALGEBRA_PARSER_H
+
+#include "register.h"
+
+#define TOKEN_END 0 ///End of the command
+#define TOKEN_ERROR 1 ///Character that can't start any token
+#define TOKEN_NUMBER 2 ///Real value
+#define TOKEN_TERM 3 ///Polynomial term "<coefficient>X^<power>"
+#define TOKEN_NAME 4 ///Name of an object or a function
+#define TOKEN_OPERATOR 5 ///One of + - * /
+#define TOKEN_LEFT_PARENTHESIS 6 ///(
+#define TOKEN_RIGHT_PARENTHESIS 7 ///)
+#define TOKEN_LEFT_BRACKET 8 ///[
+#define TOKEN_RIGHT_BRACKET 9 ///]
+#define TOKEN_COMMA 10 ///,
+#define TOKEN_SEMICOLON 11 ///;
+#define TOKEN_EQUAL 12 ///=
+#define TOKEN_STRING 13 ///Text between double quotes
+
+#define NODE_NUMBER 0 ///Real value
+#define NODE_TERM 1 ///Polynomial term
+#define NODE_NAME 2 ///Object of the register
+#define NODE_NEGATE 3 ///Opposite of the only child
+#define NODE_OPERATION 4 ///Operation between the 2 children
+#define NODE_CALL 5 ///Function applied to the children
+#define NODE_MATRIX 6 ///Matrix literal, the children are the cells in row-major order or its values are already read
+#define NODE_ASSIGNMENT 7 ///Assignment of the only child to a name
+#define NODE_STRING 8 ///Text, like the link of a file
+
+#define FUNCTION_UNKNOWN -1 ///Name that isn't a function
+#define FUNCTION_DISPLAY 0 ///display(<operation>), final
+#define FUNCTION_EIGEN_VALUES 1 ///eigValues(<operation>), final
+#define FUNCTION_SOLVE 2 ///solve(<operation>), final
+#define FUNCTION_SQUARE_FREE 3 ///squareFree(<operation>), final
+#define FUNCTION_SAVE 4 ///save(<operation>, "<file>"), final
+#define FUNCTION_TRIANGULARISE 5 ///triangularise(<operation>)
+#define FUNCTION_TRANSPOSE 6 ///trans(<operation>)
+#define FUNCTION_ADJUGATE 7 ///adj(<operation>)
+#define FUNCTION_INVERSE 8 ///inv(<operation>)
+#define FUNCTION_EIGEN_VECTORS 9 ///eigVectors(<operation>)
+#define FUNCTION_P_LAMBDA 10 ///PLambda(<operation>)
+#define FUNCTION_DERIVE 11 ///derive(<operation>)
+#define FUNCTION_TRACE 12 ///trace(<operation>)
+#define FUNCTION_DETERMINANT 13 ///det(<operation>)
+#define FUNCTION_INTERPOLATE 14 ///interp(<operation1>, <operation2>)
+#define FUNCTION_EVALUATE 15 ///evaluate(<operation1>, <operation2>)
+#define FUNCTION_GCD 16 ///gcd(<operation1>, <operation2>)
+#define FUNCTION_COMPOSE 17 ///compose(<operation1>, <operation2>)
+#define FUNCTION_SHIFT 18 ///shift(<operation1>, <operation2>)
+#define FUNCTION_LOAD 19 ///load("<file>")
+#define FUNCTION_IMPORT 20 ///import("<file>")
+#define NB_FUNCTIONS 21 ///Number of known functions
+#define NB_FINAL_FUNCTIONS 5 ///Functions with a lower index are final, they can only be used as a whole command
+
+extern const char *functionNames[NB_FUNCTIONS]; ///Names of the functions, in the order of their index
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct Token
+ * Structure representing a token of a command, it points directly in the command string
+ */
+typedef struct {
+    char type; ///Type of token
+    const char *start; ///First character of the token in the command
+    int length; ///Number of characters of the token
+    double value; ///Value of a number, coefficient of a term
+    int power; ///Power of a term
+} Token;
+
+/**
+ * @struct Lexer
+ * Structure representing the reading state of a command, the command is read only once from left to right
+ */
+typedef struct {
+    const char *string; ///Command being read
+    int position; ///Index of the next character to read
+    Token current; ///Last token read
+} Lexer;
+
+/**
+ * @struct Node
+ * Structure representing a node of the syntax tree of a command
+ */
+typedef struct Node {
+    char type; ///Type of node
+    char operator; ///Operator of an operation
+    char *name; ///Name of an object or of an assigned object, text of a string
+    int function; ///Function of a call
+    double value; ///Value of a number, coefficient of a term
+    int power; ///Power of a term
+    int rows; ///Number of rows of a matrix literal
+    int columns; ///Number of columns of a matrix literal
+    Matrix matrix; ///Values of a matrix literal only made of numbers, it doesn't have children
+    int nbChildren; ///Number of children
+    struct Node **children; ///Operands, arguments or cells
+} Node;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Lexer
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Create a lexer
+ * This function create a lexer on a command and read its first token
+ * @param string - The command to read
+ * @return lexer positioned on the first token
+ */
+Lexer newLexer(const char *string);
+
+/**
+ * Read the next token
+ * This function read the next token of the command in the current token of the lexer
+ * @param lexer - The lexer to advance
+ */
+void nextToken(Lexer *lexer);
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Parser
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Index of a function
+ * @param name - Name of the function
+ * @param length - Number of characters of the name
+ * @return index of the function, FUNCTION_UNKNOWN if there is no function with this name
+ */
+int functionIndex(const char *name, int length);
+
+/**
+ * Parse a command
+ * This function read a command once and build its syntax tree, operators are parsed by precedence climbing (* and / before + and -)
+ * @param command - The command to parse
+ * @param verbose - 1 to print the errors that can be explained to the user
+ * @return root of the syntax tree, NULL if the command isn't valid
+ */
+Node *parseCommand(const char *command, char verbose);
+
+/**
+ * Free a syntax tree
+ * @param node - Root of the tree to free
+ */
+void freeNode(Node *node);
+
+#endif //LINEARALGEBRA_PARSER_H
\ No newline at end of file
@@ -9,7 +9,26 @@
 
 Polynomial newPolynomial(int degree) {
     if (degree < 0) return nullPolynomial;
-    else return (Polynomial) {NULL, calloc(degree + 1, sizeof(double)), degree};
+    else return (Polynomial) {NULL, temporaryCalloc(degree + 1, sizeof(double)), degree};
+}
+
+Polynomial newSparsePolynomial(int nbTerms) {
+    if (nbTerms < 1) return nullPolynomial;
+    else return (Polynomial) {NULL, temporaryMalloc(nbTerms * sizeof(double)), 0, temporaryMalloc(nbTerms * sizeof(int)), nbTerms};
+}
+
+Polynomial monomial(double coefficient, int power) {
+    if (power < 0) return nullPolynomial;
+    Polynomial output;
+    if (power >= SPARSE_MIN_DEGREE && coefficient != 0) { //A single high degree term is always sparse
+        output = newSparsePolynomial(1);
+        output.coefficient[0] = coefficient; output.exponent[0] = power;
+        output.highestDegree = power;
+    } else {
+        output = newPolynomial(power);
+        output.coefficient[power] = coefficient;
+    }
+    return output;
 }
 
 Polynomial stringToPolynomial(const char *string) {
@@ -17,31 +36,64 @@ Polynomial stringToPolynomial(const char *string) {
     while (string[index] && string[index] == ' ') index++;
     //If there is a numerical coefficient read it
     if (string[index] && string[index] != 'X') coefficient = readDoubleInString(string, &index);
-    if (string[index] && string[index == 'X']) {
+    if (string[index] && string[index] == 'X') {
         if (string[++index] != '^') {
             output = newPolynomial(1);
             output.coefficient[1] = coefficient;
         } else {
             int degree = (int) readDoubleInString(string, &index);
             if (degree < 0) return newPolynomial(-1);
-            output = newPolynomial(degree);
-            output.coefficient[degree] = coefficient;
+            output = monomial(coefficient, degree);
         }
         return output;
     } else return newPolynomial(-1);
 }
 
 Polynomial copyPolynomial(Polynomial F) {
+    if (isSparse(F)) {
+        Polynomial copy = newSparsePolynomial(F.nbTerms);
+        for (int i = 0; i < F.nbTerms; i++) {
+            copy.coefficient[i] = F.coefficient[i];
+            copy.exponent[i] = F.exponent[i];
+        }
+        copy.highestDegree = F.highestDegree;
+        return copy;
+    }
     Polynomial copy = newPolynomial(F.highestDegree);
     for (int i = 0; i <= F.highestDegree; i++) copy.coefficient[i] = F.coefficient[i];
     return copy;
 }
 
 void freePolynomial(Polynomial *F) {
-    if (F) free(F->coefficient);
+    if (F) {
+        if (F->references && --*F->references > 0) return; //Other holders still use the coefficients
+        temporaryFree(F->coefficient);
+        temporaryFree(F->exponent);
+        free(F->references);
+    }
+}
+
+Polynomial promotePolynomial(Polynomial F) {
+    if (!inArena(F.coefficient) && !inArena(F.exponent)) return F;
+    pauseArena();
+    Polynomial copy = copyPolynomial(F);
+    resumeArena();
+    copy.name = F.name;
+    return copy;
+}
+
+Polynomial sharePolynomial(Polynomial F) {
+    if (!F.coefficient) return F;
+    if (F.references) (*F.references)++;
+    else { //A temporary result gets its first holder
+        F.references = malloc(sizeof(int));
+        *F.references = 1;
+    }
+    return F;
 }
 
 double apply(Polynomial F, double x) {
+    if (isSparse(F)) return sparseApply(F, x);
     double result = F.coefficient[0], powerOfX = x;
     for (int i = 1; i <= F.highestDegree; i++) {
         result += F.coefficient[i] * powerOfX;
@@ -51,6 +103,7 @@ double apply(Polynomial F, double x) {
 }
 
 Polynomial derive(Polynomial F) {
+    if (isSparse(F)) return adaptPolynomialForm(sparseDerive(F));
     Polynomial FPrime;
     if (F.highestDegree == 0) {
         FPrime = newPolynomial(F.highestDegree);
@@ -62,46 +115,63 @@ Polynomial derive(Polynomial F) {
     return FPrime;
 }
 
+void printTerm(double coefficient, int power, char first) {
+    //Choose the sign
+    int sign = 1;
+    if (!first) {
+        if (coefficient < 0) {
+            writeText(" - ");
+            sign = -1;
+        } else writeText(" + ");
+    }
+    //Print the value with the power of X
+    if (power == 0) writeNumber(coefficient * sign, 1);
+    else if (power == 1) {
+        if (coefficient == 1) writeText("X");
+        else {
+            writeNumber(coefficient * sign, 1); writeText("X");
+        }
+    } else {
+        if (coefficient == 1) writeFormat("X^%d", power);
+        else {
+            writeNumber(coefficient * sign, 1); writeFormat("X^%d", power);
+        }
+    }
+}
+
 void printPolynomial(Polynomial F) {
-    if (F.name) printf("%s(X) = ", F.name);
-    if (F.highestDegree == 0 && F.coefficient[0] == 0) printf("0");
+    if (F.name) writeFormat("%s(X) = ", F.name);
+    if (isSparse(F)) {
+        for (int i = F.nbTerms - 1; i >= 0; i--) printTerm(F.coefficient[i], F.exponent[i], i == F.nbTerms - 1);
+    } else if (F.highestDegree == 0 && F.coefficient[0] == 0) writeText("0");
     else {
         for (int i = F.highestDegree; i >= 0; i--) {
-            if (F.coefficient[i]) {
-                //Choose the sign
-                int sign = 1;
-                if (i != F.highestDegree) {
-                    if (F.coefficient[i] < 0) {
-                        printf(" - ");
-                        sign = -1;
-                    } else printf(" + ");
-                }
-                //Print the value with the power of X
-                if (i == 0) printf("%1.1lf", F.coefficient[i] * sign);
-                else if (i == 1) {
-                    if (F.coefficient[i] == 1) printf("X");
-                    else printf("%1.1lfX", F.coefficient[i] * sign);
-                } else {
-                    if (F.coefficient[i] == 1) printf("X^%d", i);
-                    else printf("%1.1lfX^%d", F.coefficient[i] * sign, i);
-                }
-            }
+            if (F.coefficient[i]) printTerm(F.coefficient[i], i, i == F.highestDegree);
         }
     }
-    printf("\n");
+    writeText("\n");
 }
 
 void eliminateNullCoefficients(Polynomial *F) {
-    for (int i = F->highestDegree; i > 0; i++) {
-        if (F->coefficient[i] == 0) {
-            Polynomial temp = newPolynomial(F->highestDegree - 1);
-            for (int j = 0; j <= temp.highestDegree; j++) temp.coefficient[j] = F->coefficient[j];
-            *F = temp;
-        } else break;
-    }
+    while (F->highestDegree > 0 && F->coefficient[F->highestDegree] == 0) F->highestDegree--;
+}
+
+/**
+ * Free a polynomial converted to another form
+ * @param converted - The polynomial given by toSparsePolynomial or toDensePolynomial
+ * @param original - The polynomial which was converted, the converted one is freed only if it is a copy of it
+ */
+void freeConvertedPolynomial(Polynomial *converted, Polynomial original) {
+    if (converted->coefficient != original.coefficient) freePolynomial(converted);
 }
 
 Polynomial pAdd(Polynomial F, Polynomial G) {
+    if (isSparse(F) || isSparse(G)) {
+        Polynomial sparseF = toSparsePolynomial(F), sparseG = toSparsePolynomial(G);
+        Polynomial output = adaptPolynomialForm(sparseAdd(sparseF, sparseG, 1));
+        freeConvertedPolynomial(&sparseF, F); freeConvertedPolynomial(&sparseG, G);
+        return output;
+    }
     Polynomial lowerPolynomial, higherPolynomial;
     if (F.highestDegree < G.highestDegree) {
         lowerPolynomial = F;
@@ -124,6 +194,12 @@ Polynomial pAdd(Polynomial F, Polynomial G) {
 }
 
 Polynomial pMinus(Polynomial F, Polynomial G) {
+    if (isSparse(F) || isSparse(G)) {
+        Polynomial sparseF = toSparsePolynomial(F), sparseG = toSparsePolynomial(G);
+        Polynomial output = adaptPolynomialForm(sparseAdd(sparseF, sparseG, -1));
+        freeConvertedPolynomial(&sparseF, F); freeConvertedPolynomial(&sparseG, G);
+        return output;
+    }
     int highestDegree = F.highestDegree > G.highestDegree ? F.highestDegree : G.highestDegree;
     Polynomial output = newPolynomial(highestDegree);
 
@@ -140,6 +216,13 @@ Polynomial pMinus(Polynomial F, Polynomial G) {
 }
 
 Polynomial pMultiply(Polynomial F, Polynomial G) {
+    if (isSparse(F) || isSparse(G)) {
+        Polynomial sparseF = toSparsePolynomial(F), sparseG = toSparsePolynomial(G);
+        Polynomial output = adaptPolynomialForm(sparseMultiply(sparseF, sparseG));
+        freeConvertedPolynomial(&sparseF, F); freeConvertedPolynomial(&sparseG, G);
+        return output;
+    }
+    if (F.highestDegree >= KARATSUBA_THRESHOLD && G.highestDegree >= KARATSUBA_THRESHOLD) return pFastMultiply(F, G);
     Polynomial output = newPolynomial(F.highestDegree + G.highestDegree);
     for (int i = 0; i <= F.highestDegree; i++) {
         for (int j = 0; j <= G.highestDegree; j++) output.coefficient[i + j] += F.coefficient[i] * G.coefficient[j];
@@ -148,7 +231,59 @@ Polynomial pMultiply(Polynomial F, Polynomial G) {
     return output;
 }
 
+/**
+ * Karatsuba multiplication of coefficient arrays
+ * This function multiply 2 arrays of n coefficients and write the 2n - 1 coefficients of the product in result
+ * @param a - first array of coefficients
+ * @param b - second array of coefficients
+ * @param n - number of coefficients in each array
+ * @param result - array of 2n - 1 coefficients where the product is written
+ */
+void karatsuba(const double *a, const double *b, int n, double *result) {
+    for (int i = 0; i < 2 * n - 1; i++) result[i] = 0;
+    if (n <= KARATSUBA_THRESHOLD) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) result[i + j] += a[i] * b[j];
+        }
+        return;
+    }
+    //Split in a lower half of h coefficients and a higher half of k coefficients
+    int h = n / 2, k = n - h;
+    double *sumA = malloc(k * sizeof(double)), *sumB = malloc(k * sizeof(double));
+    double *z0 = malloc((2 * h - 1) * sizeof(double)), *z1 = malloc((2 * k - 1) * sizeof(double)), *z2 = malloc((2 * k - 1) * sizeof(double));
+    for (int i = 0; i < k; i++) {
+        sumA[i] = a[h + i] + (i < h ? a[i] : 0);
+        sumB[i] = b[h + i] + (i < h ? b[i] : 0);
+    }
+    karatsuba(a, b, h, z0);
+    karatsuba(a + h, b + h, k, z2);
+    karatsuba(sumA, sumB, k, z1);
+    //z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    for (int i = 0; i < 2 * h - 1; i++) z1[i] -= z0[i];
+    for (int i = 0; i < 2 * k - 1; i++) z1[i] -= z2[i];
+    for (int i = 0; i < 2 * h - 1; i++) result[i] += z0[i];
+    for (int i = 0; i < 2 * k - 1; i++) result[h + i] += z1[i];
+    for (int i = 0; i < 2 * k - 1; i++) result[2 * h + i] += z2[i];
+    free(sumA); free(sumB); free(z0); free(z1); free(z2);
+}
+
+Polynomial pFastMultiply(Polynomial F, Polynomial G) {
+    if (isSparse(F) || isSparse(G)) return pMultiply(F, G);
+    int n = (F.highestDegree > G.highestDegree ? F.highestDegree : G.highestDegree) + 1;
+    //Pad both polynomials to the same number of coefficients
+    double *a = calloc(n, sizeof(double)), *b = calloc(n, sizeof(double)), *result = malloc((2 * n - 1) * sizeof(double));
+    for (int i = 0; i <= F.highestDegree; i++) a[i] = F.coefficient[i];
+    for (int i = 0; i <= G.highestDegree; i++) b[i] = G.coefficient[i];
+    karatsuba(a, b, n, result);
+    Polynomial output = newPolynomial(F.highestDegree + G.highestDegree);
+    for (int i = 0; i <= output.highestDegree; i++) output.coefficient[i] = result[i];
+    free(a); free(b); free(result);
+    eliminateNullCoefficients(&output);
+    return output;
+}
+
 char isPolynomialNull(Polynomial F) {
+    if (isSparse(F)) return 0; //Sparse polynomials never contain null coefficients
     char nonNullValue = 0;
     for (int i = 0; i <= F.highestDegree; i++) {
         if (F.coefficient[i]) nonNullValue = 1;
@@ -157,24 +292,154 @@ char isPolynomialNull(Polynomial F) {
     else return 1;
 }
 
-Polynomial pLongDivide(Polynomial numerator, Polynomial denominator) {
-    if (!isPolynomialNull(denominator)) {
-        Polynomial quotient = newPolynomial(0), remainder = numerator;
-        while (!isPolynomialNull(remainder) && remainder.highestDegree >= denominator.highestDegree) {
-            Polynomial temp = newPolynomial(remainder.highestDegree - denominator.highestDegree);
-            highestCoefficient(temp) = highestCoefficient(remainder) / highestCoefficient(denominator);
-            quotient = pAdd(quotient, temp);
-            remainder = pMinus(remainder, pMultiply(temp, denominator));
+/**
+ * Verify if a polynomial is negligible
+ * This function return 1 if all coefficients of a polynomial are negligible compared to a given scale
+ * @param F - The polynomial to check
+ * @param scale - Order of magnitude of the coefficients the polynomial is compared to
+ * @return result of the check
+ */
+char isPolynomialNegligible(Polynomial F, double scale) {
+    int size = isSparse(F) ? F.nbTerms : F.highestDegree + 1;
+    for (int i = 0; i < size; i++) if (absolute(F.coefficient[i]) > GCD_TOLERANCE * scale) return 0;
+    return 1;
+}
+
+/**
+ * Scale of a polynomial
+ * @param F - The polynomial, dense or sparse
+ * @return largest absolute value of the coefficients of F
+ */
+double polynomialScale(Polynomial F) {
+    double scale = 0;
+    int size = isSparse(F) ? F.nbTerms : F.highestDegree + 1;
+    for (int i = 0; i < size; i++) if (absolute(F.coefficient[i]) > scale) scale = absolute(F.coefficient[i]);
+    return scale;
+}
+
+/**
+ * Truncate a polynomial
+ * This function return a copy of a dense polynomial keeping only the coefficients of the powers lower than the given length (F mod X^length)
+ * @param F - The polynomial to truncate
+ * @param length - Number of coefficients to keep
+ * @return F mod X^length
+ */
+Polynomial truncatePolynomial(Polynomial F, int length) {
+    Polynomial truncated = newPolynomial((F.highestDegree < length ? F.highestDegree + 1 : length) - 1);
+    for (int i = 0; i <= truncated.highestDegree; i++) truncated.coefficient[i] = F.coefficient[i];
+    return truncated;
+}
+
+/**
+ * Reverse a polynomial
+ * This function return X^degree * F(1/X), the coefficients of F in reverse order
+ * @param F - The polynomial to reverse
+ * @param degree - The degree used for the reversal, must be at least the degree of F
+ * @return reversed polynomial
+ */
+Polynomial reversePolynomial(Polynomial F, int degree) {
+    Polynomial reversed = newPolynomial(degree);
+    for (int i = 0; i <= F.highestDegree && i <= degree; i++) reversed.coefficient[degree - i] = F.coefficient[i];
+    return reversed;
+}
+
+/**
+ * Inverse of a power series
+ * This function use Newton iterations to compute G such that F * G = 1 mod X^precision, the precision doubling at each step
+ * @warning The constant coefficient of F must not be null
+ * @param F - The series to inverse
+ * @param precision - Number of coefficients of the inverse to compute
+ * @return 1 / F mod X^precision
+ */
+Polynomial inverseSeries(Polynomial F, int precision) {
+    Polynomial G = newPolynomial(0);
+    G.coefficient[0] = 1 / F.coefficient[0];
+    for (int k = 1; k < precision;) {
+        k = 2 * k < precision ? 2 * k : precision;
+        //G = G * (2 - F * G) mod X^k
+        Polynomial truncatedF = truncatePolynomial(F, k), product = pMultiply(truncatedF, G), error = truncatePolynomial(product, k);
+        for (int i = 0; i <= error.highestDegree; i++) error.coefficient[i] = -error.coefficient[i];
+        error.coefficient[0] += 2;
+        Polynomial corrected = pMultiply(G, error);
+        freePolynomial(&G);
+        G = truncatePolynomial(corrected, k);
+        freePolynomial(&truncatedF); freePolynomial(&product); freePolynomial(&error); freePolynomial(&corrected);
+    }
+    return G;
+}
+
+/**
+ * Euclidean division of dense polynomials
+ * @param numerator - Dense numerator
+ * @param denominator - Dense denominator
+ * @param quotient - Filled with the quotient, can be NULL
+ * @param remainder - Filled with the remainder, can be NULL
+ * @return 1 if the division was done, 0 if the denominator is null
+ */
+char denseDivideWithRemainder(Polynomial numerator, Polynomial denominator, Polynomial *quotient, Polynomial *remainder) {
+    eliminateNullCoefficients(&denominator);
+    if (isPolynomialNull(denominator)) return 0;
+    int n = numerator.highestDegree, m = denominator.highestDegree;
+    if (n < m) {
+        if (quotient) *quotient = newPolynomial(0);
+        if (remainder) *remainder = copyPolynomial(numerator);
+        return 1;
+    }
+    Polynomial q, r;
+    if (m < FAST_DIVISION_THRESHOLD || n - m < FAST_DIVISION_THRESHOLD) { //Classical long division on the coefficients
+        double *rest = malloc((n + 1) * sizeof(double));
+        for (int i = 0; i <= n; i++) rest[i] = numerator.coefficient[i];
+        q = newPolynomial(n - m);
+        for (int i = n - m; i >= 0; i--) {
+            q.coefficient[i] = rest[i + m] / highestCoefficient(denominator);
+            for (int j = 0; j <= m; j++) rest[i + j] -= q.coefficient[i] * denominator.coefficient[j];
         }
-        if (!isPolynomialNull(remainder)) {
-            printf("There is a remainder in the long division : ");
+        r = newPolynomial(m > 0 ? m - 1 : 0);
+        for (int i = 0; i < m; i++) r.coefficient[i] = rest[i];
+        free(rest);
+    } else { //Newton division, rev(q) = rev(numerator) / rev(denominator) mod X^(n - m + 1)
+        Polynomial reversedNumerator = reversePolynomial(numerator, n), reversedDenominator = reversePolynomial(denominator, m);
+        Polynomial inverse = inverseSeries(reversedDenominator, n - m + 1);
+        Polynomial truncatedNumerator = truncatePolynomial(reversedNumerator, n - m + 1), product = pMultiply(truncatedNumerator, inverse);
+        Polynomial reversedQuotient = truncatePolynomial(product, n - m + 1);
+        q = reversePolynomial(reversedQuotient, n - m);
+        //r = numerator - q * denominator, only the m lowest coefficients are non null
+        Polynomial qTimesDenominator = pMultiply(q, denominator);
+        r = newPolynomial(m > 0 ? m - 1 : 0);
+        for (int i = 0; i < m; i++) r.coefficient[i] = numerator.coefficient[i] - (i <= qTimesDenominator.highestDegree ? qTimesDenominator.coefficient[i] : 0);
+        freePolynomial(&reversedNumerator); freePolynomial(&reversedDenominator); freePolynomial(&inverse);
+        freePolynomial(&truncatedNumerator); freePolynomial(&product); freePolynomial(&reversedQuotient); freePolynomial(&qTimesDenominator);
+    }
+    eliminateNullCoefficients(&q); eliminateNullCoefficients(&r);
+    if (quotient) *quotient = q;
+    else freePolynomial(&q);
+    if (remainder) *remainder = r;
+    else freePolynomial(&r);
+    return 1;
+}
+
+char pDivideWithRemainder(Polynomial numerator, Polynomial denominator, Polynomial *quotient, Polynomial *remainder) {
+    Polynomial denseNumerator = toDensePolynomial(numerator), denseDenominator = toDensePolynomial(denominator);
+    char divided = denseDivideWithRemainder(denseNumerator, denseDenominator, quotient, remainder);
+    freeConvertedPolynomial(&denseNumerator, numerator); freeConvertedPolynomial(&denseDenominator, denominator);
+    return divided;
+}
+
+Polynomial pLongDivide(Polynomial numerator, Polynomial denominator) {
+    Polynomial quotient, remainder;
+    if (pDivideWithRemainder(numerator, denominator, &quotient, &remainder)) {
+        //A remainder negligible compared to the numerator is a rounding residual of an exact division
+        if (!isPolynomialNegligible(remainder, polynomialScale(numerator))) {
+            writeText("There is a remainder in the long division : ");
             printPolynomial(remainder);
         }
+        freePolynomial(&remainder);
         return quotient;
     } else return newPolynomial(-1);
 }
 
 Polynomial syntheticDivision(Polynomial F, double root) {
+    F = toDensePolynomial(F);
     Polynomial quotient = newPolynomial(F.highestDegree - 1);
     double temp = highestCoefficient(F);
     for (int i = 0, j = 0; i < F.highestDegree; i++) {
@@ -187,69 +452,335 @@ Polynomial syntheticDivision(Polynomial F, double root) {
     return quotient;
 }
 
-double searchNull(Polynomial F) {
-    double leftIndex = 0, rightIndex = 0, temp;
-    Polynomial fPrime = derive(F);
-    for (int i = 0; absolute(apply(fPrime, leftIndex)) < 1000 && absolute(apply(fPrime, rightIndex)) < 1000; i++) {
-        //Search on the left side
-        temp = leftIndex;
-        //Move the index to the left
-        if (apply(fPrime, leftIndex) < 0) leftIndex += apply(fPrime, leftIndex);
-        else leftIndex--;
-        //Verify if 0 is in the interval
-        if (apply(F, leftIndex) == 0) return leftIndex;
-        else if (apply(F, temp) == 0) return temp;
-        else if (apply(F, leftIndex) * apply(F, temp) < 0) return (leftIndex - temp) / 2;
-        //Search on the right side
-        temp = rightIndex;
-        //Move the index to the right
-        if (apply(fPrime, rightIndex) > 0) leftIndex += apply(fPrime, rightIndex);
-        else rightIndex++;
-        //Verify if 0 is in the interval
-        if (apply(F, rightIndex) == 0) return rightIndex;
-        else if (apply(F, temp) == 0) return temp;
-        else if (apply(F, rightIndex) * apply(F, temp) < 0) return (rightIndex - temp) / 2;
+SturmSequence newSturmSequence(Polynomial F) {
+    SturmSequence sequence = {0, NULL};
+    F = toDensePolynomial(F);
+    if (F.highestDegree < 1) return sequence;
+    sequence.polynomials = malloc((F.highestDegree + 1) * sizeof(Polynomial));
+    sequence.polynomials[sequence.size++] = copyPolynomial(F);
+    sequence.polynomials[sequence.size++] = derive(F);
+    //P(k+1) = -rem(P(k-1), P(k)), each term is scaled by a positive value to keep its coefficients around 1
+    while (sequence.polynomials[sequence.size - 1].highestDegree > 0) {
+        Polynomial remainder, previous = sequence.polynomials[sequence.size - 2];
+        pDivideWithRemainder(previous, sequence.polynomials[sequence.size - 1], NULL, &remainder);
+        double scale = 0;
+        for (int i = 0; i <= previous.highestDegree; i++) if (absolute(previous.coefficient[i]) > scale) scale = absolute(previous.coefficient[i]);
+        if (isPolynomialNegligible(remainder, scale)) { //F has multiple roots, the last term is their GCD
+            freePolynomial(&remainder); break;
+        }
+        double highestValue = absolute(highestCoefficient(remainder));
+        for (int i = 0; i <= remainder.highestDegree; i++) remainder.coefficient[i] = -remainder.coefficient[i] / highestValue;
+        sequence.polynomials[sequence.size++] = remainder;
     }
-    return 1;
+    return sequence;
+}
+
+void freeSturmSequence(SturmSequence *sequence) {
+    if (sequence) {
+        for (int i = 0; i < sequence->size; i++) freePolynomial(&sequence->polynomials[i]);
+        free(sequence->polynomials);
+        *sequence = (SturmSequence) {0, NULL};
+    }
+}
+
+int signChanges(SturmSequence sequence, double x) {
+    int changes = 0;
+    for (int i = 0, previousSign = 0; i < sequence.size; i++) {
+        double value = apply(sequence.polynomials[i], x);
+        int sign = value > 0 ? 1 : value < 0 ? -1 : 0;
+        if (sign != 0) {
+            if (previousSign != 0 && sign != previousSign) changes++;
+            previousSign = sign;
+        }
+    }
+    return changes;
+}
+
+double rootBound(Polynomial F) {
+    F = toDensePolynomial(F);
+    //Cauchy bound, all roots are strictly inside ]-bound, bound[
+    double highestRatio = 0;
+    for (int i = 0; i < F.highestDegree; i++) {
+        double ratio = absolute(F.coefficient[i] / highestCoefficient(F));
+        if (ratio > highestRatio) highestRatio = ratio;
+    }
+    return 1 + highestRatio;
+}
+
+Intervals isolateRealRoots(Polynomial F) {
+    Intervals intervals = {0, NULL};
+    SturmSequence sequence = newSturmSequence(F);
+    if (sequence.size == 0) return intervals;
+    double bound = rootBound(F);
+    intervals.values = malloc(F.highestDegree * sizeof(Interval));
+    //Bisection with an explicit stack of intervals and the sign changes at their bounds
+    int stackSize = 1, capacity = 2 * ISOLATION_MAX_DEPTH + 2;
+    typedef struct {double lower, upper; int lowerChanges, upperChanges, depth;} Bisection;
+    Bisection *stack = malloc(capacity * sizeof(Bisection));
+    stack[0].lower = -bound; stack[0].upper = bound; stack[0].depth = 0;
+    stack[0].lowerChanges = signChanges(sequence, -bound); stack[0].upperChanges = signChanges(sequence, bound);
+    while (stackSize > 0) {
+        stackSize--;
+        double lower = stack[stackSize].lower, upper = stack[stackSize].upper;
+        int lowerChanges = stack[stackSize].lowerChanges, upperChanges = stack[stackSize].upperChanges, depth = stack[stackSize].depth;
+        int nbRoots = lowerChanges - upperChanges;
+        if (nbRoots <= 0) continue;
+        if (nbRoots == 1 || depth >= ISOLATION_MAX_DEPTH) { //Isolated, or a cluster too tight to separate in double precision
+            for (int i = 0; i < nbRoots && intervals.size < F.highestDegree; i++) intervals.values[intervals.size++] = (Interval) {lower, upper};
+            continue;
+        }
+        double middle = (lower + upper) / 2;
+        //Avoid cutting exactly on a root, the Sturm count wouldn't be valid there
+        if (apply(F, middle) == 0) middle += (upper - lower) / 64;
+        int middleChanges = signChanges(sequence, middle);
+        //The upper half is pushed first so that roots come out in increasing order
+        stack[stackSize++] = (Bisection) {middle, upper, middleChanges, upperChanges, depth + 1};
+        stack[stackSize++] = (Bisection) {lower, middle, lowerChanges, middleChanges, depth + 1};
+    }
+    free(stack); freeSturmSequence(&sequence);
+    return intervals;
+}
+
+double refineRoot(Polynomial F, Polynomial fPrime, Interval interval) {
+    double lower = interval.lower, upper = interval.upper, lowerValue = apply(F, lower), upperValue = apply(F, upper);
+    if (lowerValue == 0) return lower;
+    if (upperValue == 0) return upper;
+    if (lowerValue * upperValue > 0) return (lower + upper) / 2; //Cluster of roots without sign change
+    //Orient the bracket so that F(negativeSide) < 0
+    double negativeSide = lowerValue < 0 ? lower : upper, positiveSide = lowerValue < 0 ? upper : lower;
+    double x = (lower + upper) / 2, previousStep = upper - lower, step = previousStep;
+    for (int i = 0; i < REFINE_MAX_ITERATIONS; i++) {
+        double y = apply(F, x), yPrime = apply(fPrime, x);
+        if (y == 0) return x;
+        if (y < 0) negativeSide = x;
+        else positiveSide = x;
+        //Newton step if it stays inside the bracket and converges fast enough, bisection otherwise
+        double newton = yPrime != 0 ? x - y / yPrime : negativeSide;
+        if (yPrime == 0 || (newton - negativeSide) * (newton - positiveSide) > 0 || absolute(2 * y) > absolute(previousStep * yPrime)) {
+            previousStep = step;
+            step = (positiveSide - negativeSide) / 2;
+            x = negativeSide + step;
+        } else {
+            previousStep = step;
+            step = x - newton;
+            x = newton;
+        }
+        if (absolute(step) <= 1e-15 * (1 + absolute(x))) return x;
+    }
+    return x;
 }
 
 double newtonMethod(Polynomial F) {
     if (F.highestDegree > 0) {
-        //Initialisation
-        double x0 = searchNull(F), x1, tolerance = 1e-9, epsilon = 1e-15;
-        Polynomial fPrime = derive(F);
-        char maxIterations = 50, solutionFound = 0;
-        //Application of the method until precision or number of iterations is reached
-        for (int i = 1; i < maxIterations; i++) {
-            double y = apply(F, x0), yPrime = apply(fPrime, x0);
-            if (absolute(yPrime) < epsilon) break;
-            x1 = x0 - y / yPrime;
-            if (absolute(x1 - x0) <= tolerance) {
-                solutionFound = 1; break;
-            }
-            x0 = x1;
+        Intervals intervals = isolateRealRoots(F);
+        if (intervals.size > 0) {
+            Polynomial fPrime = derive(F);
+            double root = refineRoot(F, fPrime, intervals.values[0]);
+            free(intervals.values); freePolynomial(&fPrime);
+            return root;
         }
-        //End of the method, free temporary values and return output
-        freePolynomial(&fPrime);
-        if (solutionFound) return x1;
     }
     return IMAGINARY;
 }
 
-Polynomial depress(Polynomial F) {
-    if (F.highestDegree == 4) {
-        Polynomial depressedForm = copyPolynomial(F);
-        double A = depressedForm.coefficient[4], B = depressedForm.coefficient[3], C = depressedForm.coefficient[2], D = depressedForm.coefficient[1], E = depressedForm.coefficient[0];
-        depressedForm.coefficient[4] = 1;
-        depressedForm.coefficient[3] = 0;
-        depressedForm.coefficient[2] = (-3 * power(B, 2)) / (8 * power(A, 2)) + C / A;
-        depressedForm.coefficient[1] = power(B, 3) / (8 * power(A, 3)) - (B * C) / (2 * power(A, 2)) + D / A;
-        depressedForm.coefficient[0] = (-3 * power(B, 4)) / (256 * power(A, 4)) + (C * power(B, 2)) / (16 * power(A, 3)) - (B * D) / (4 * power(A, 2)) + E / A;
-        return depressedForm;
-    } else return F;
+Polynomial taylorShift(Polynomial F, double a) {
+    Polynomial shifted = copyPolynomial(toDensePolynomial(F));
+    if (a == 0) return shifted;
+    //Repeated synthetic division by X - a, the coefficients are updated in place
+    for (int i = 0; i < shifted.highestDegree; i++) {
+        for (int j = shifted.highestDegree - 1; j >= i; j--) shifted.coefficient[j] += a * shifted.coefficient[j + 1];
+    }
+    return shifted;
+}
+
+/**
+ * Compose part of a polynomial
+ * This function compose the polynomial formed by some coefficients with G, the lower and higher halves are composed separately and combined with a power of G
+ * @param coefficients - Coefficients of the polynomial to compose
+ * @param nbCoefficients - Number of coefficients, at most 2^level
+ * @param powersOfG - G^(2^j) for each j lower than level
+ * @param level - Level of the recursion
+ * @return composed polynomial
+ */
+Polynomial composeCoefficients(const double *coefficients, int nbCoefficients, Polynomial *powersOfG, int level) {
+    if (level == 0) {
+        Polynomial constant = newPolynomial(0);
+        constant.coefficient[0] = coefficients[0];
+        return constant;
+    }
+    //F = low + X^half * high => F(G) = low(G) + G^half * high(G)
+    int half = 1 << (level - 1);
+    if (nbCoefficients <= half) return composeCoefficients(coefficients, nbCoefficients, powersOfG, level - 1);
+    Polynomial low = composeCoefficients(coefficients, half, powersOfG, level - 1);
+    Polynomial high = composeCoefficients(coefficients + half, nbCoefficients - half, powersOfG, level - 1);
+    Polynomial shiftedHigh = pMultiply(powersOfG[level - 1], high);
+    Polynomial result = pAdd(low, shiftedHigh);
+    freePolynomial(&low); freePolynomial(&high); freePolynomial(&shiftedHigh);
+    return result;
+}
+
+Polynomial compose(Polynomial F, Polynomial G) {
+    F = toDensePolynomial(F);
+    if (F.highestDegree < 0 || G.highestDegree < 0) return nullPolynomial;
+    int level = 0;
+    while ((1 << level) < F.highestDegree + 1) level++;
+    Polynomial *powersOfG = malloc((level + 1) * sizeof(Polynomial));
+    for (int j = 0; j < level; j++) powersOfG[j] = j == 0 ? copyPolynomial(G) : pMultiply(powersOfG[j - 1], powersOfG[j - 1]);
+    Polynomial result = composeCoefficients(F.coefficient, F.highestDegree + 1, powersOfG, level);
+    for (int j = 0; j < level; j++) freePolynomial(&powersOfG[j]);
+    free(powersOfG);
+    return result;
+}
+
+Polynomial depress(Polynomial F, double *shift) {
+    F = toDensePolynomial(F);
+    eliminateNullCoefficients(&F);
+    //X -> X - b / (n * a) removes the coefficient of X^(n-1)
+    *shift = F.highestDegree > 0 ? -F.coefficient[F.highestDegree - 1] / (F.highestDegree * highestCoefficient(F)) : 0;
+    Polynomial depressedForm = taylorShift(F, *shift);
+    double highestValue = highestCoefficient(depressedForm);
+    for (int i = 0; i <= depressedForm.highestDegree; i++) depressedForm.coefficient[i] /= highestValue;
+    if (depressedForm.highestDegree > 0) depressedForm.coefficient[depressedForm.highestDegree - 1] = 0;
+    return depressedForm;
+}
+
+Polynomial monicPolynomial(Polynomial F) {
+    F = toDensePolynomial(F);
+    eliminateNullCoefficients(&F);
+    Polynomial monic = newPolynomial(F.highestDegree);
+    for (int i = 0; i <= F.highestDegree; i++) monic.coefficient[i] = F.coefficient[i] / highestCoefficient(F);
+    return monic;
+}
+
+Polynomial pGcd(Polynomial F, Polynomial G) {
+    F = toDensePolynomial(F); G = toDensePolynomial(G);
+    //An operand negligible compared to the other one is a rounding residual of a null polynomial
+    double scaleF = polynomialScale(F), scaleG = polynomialScale(G);
+    if (isPolynomialNegligible(G, scaleF)) return isPolynomialNull(F) ? newPolynomial(0) : monicPolynomial(F);
+    if (isPolynomialNegligible(F, scaleG)) return monicPolynomial(G);
+    //Euclidean algorithm on monic polynomials, a remainder negligible compared to the dividend is considered null
+    Polynomial a = monicPolynomial(F.highestDegree >= G.highestDegree ? F : G), b = monicPolynomial(F.highestDegree >= G.highestDegree ? G : F);
+    while (b.highestDegree > 0) {
+        Polynomial remainder;
+        pDivideWithRemainder(a, b, NULL, &remainder);
+        double scale = 1;
+        for (int i = 0; i <= a.highestDegree; i++) if (absolute(a.coefficient[i]) > scale) scale = absolute(a.coefficient[i]);
+        freePolynomial(&a);
+        a = b;
+        if (isPolynomialNegligible(remainder, scale)) {
+            freePolynomial(&remainder);
+            return a;
+        }
+        b = monicPolynomial(remainder);
+        freePolynomial(&remainder);
+    }
+    //The last remainder is a non null constant, the polynomials are coprime
+    freePolynomial(&a); freePolynomial(&b);
+    Polynomial one = newPolynomial(0);
+    one.coefficient[0] = 1;
+    return one;
+}
+
+/**
+ * Add a factor to a factorization
+ * @param factorization - The factorization to complete
+ * @param factor - The factor to add
+ * @param multiplicity - Multiplicity of the factor
+ */
+void addFactor(Factorization *factorization, Polynomial factor, int multiplicity) {
+    factorization->factors = realloc(factorization->factors, (factorization->size + 1) * sizeof(Polynomial));
+    factorization->multiplicities = realloc(factorization->multiplicities, (factorization->size + 1) * sizeof(int));
+    factorization->factors[factorization->size] = factor;
+    factorization->multiplicities[factorization->size++] = multiplicity;
+}
+
+Factorization squareFreeDecomposition(Polynomial F) {
+    Factorization factorization = {0, NULL, NULL};
+    F = toDensePolynomial(F);
+    if (F.highestDegree < 1) return factorization;
+    //Yun's algorithm: b = F / gcd(F, F'), d = F' / gcd(F, F') - b', then each a_i = gcd(b, d) is the product of the roots of multiplicity i
+    Polynomial FPrime = derive(F), a = pGcd(F, FPrime), b, c, d, bPrime;
+    pDivideWithRemainder(F, a, &b, NULL);
+    pDivideWithRemainder(FPrime, a, &c, NULL);
+    bPrime = derive(b); d = pMinus(c, bPrime);
+    freePolynomial(&FPrime); freePolynomial(&a); freePolynomial(&c); freePolynomial(&bPrime);
+    //No root of F has a multiplicity higher than its degree, the loop stops then even if b keeps rounding residuals
+    for (int multiplicity = 1; b.highestDegree > 0 && multiplicity <= F.highestDegree; multiplicity++) {
+        a = pGcd(b, d);
+        if (a.highestDegree > 0) addFactor(&factorization, a, multiplicity);
+        Polynomial nextB;
+        pDivideWithRemainder(b, a, &nextB, NULL);
+        pDivideWithRemainder(d, a, &c, NULL);
+        if (a.highestDegree == 0) freePolynomial(&a);
+        freePolynomial(&b); freePolynomial(&d);
+        b = nextB; bPrime = derive(b); d = pMinus(c, bPrime);
+        freePolynomial(&c); freePolynomial(&bPrime);
+    }
+    freePolynomial(&b); freePolynomial(&d);
+    return factorization;
+}
+
+void freeFactorization(Factorization *factorization) {
+    if (factorization) {
+        for (int i = 0; i < factorization->size; i++) freePolynomial(&factorization->factors[i]);
+        free(factorization->factors); free(factorization->multiplicities);
+        *factorization = (Factorization) {0, NULL, NULL};
+    }
+}
+
+void printFactorization(Factorization factorization) {
+    if (factorization.size == 0) writeText("1\n");
+    for (int i = 0; i < factorization.size; i++) {
+        writeText("(");
+        Polynomial factor = factorization.factors[i];
+        factor.name = NULL;
+        for (int j = factor.highestDegree; j >= 0; j--) {
+            if (factor.coefficient[j]) printTerm(factor.coefficient[j], j, j == factor.highestDegree);
+        }
+        if (factorization.multiplicities[i] > 1) writeFormat(")^%d", factorization.multiplicities[i]);
+        else writeText(")");
+        if (i < factorization.size - 1) writeText(" * ");
+    }
+    writeText("\n");
+}
+
+/**
+ * Compare two roots for qsort
+ * @param a - First root
+ * @param b - Second root
+ * @return negative if a is lower than b, positive if it is higher, 0 if they are equal
+ */
+int compareRoots(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
 }
 
 Solutions *solve(Polynomial F) {
+    F = toDensePolynomial(F);
+    if (F.highestDegree > 1) {
+        //Solve each square-free factor separately, their roots are simple so the multiplicities come from the decomposition
+        Factorization factorization = squareFreeDecomposition(F);
+        if (factorization.size > 1 || (factorization.size == 1 && factorization.multiplicities[0] > 1)) {
+            Solutions *x = malloc(sizeof(Solutions));
+            *x = (Solutions) {0, malloc(F.highestDegree * sizeof(double))};
+            for (int i = 0; i < factorization.size && x; i++) {
+                Solutions *factorRoots = solve(factorization.factors[i]);
+                if (!factorRoots) { //Complex roots
+                    free(x->values); free(x); x = NULL;
+                } else {
+                    for (int j = 0; j < factorRoots->size; j++) {
+                        for (int k = 0; k < factorization.multiplicities[i] && x->size < F.highestDegree; k++) x->values[x->size++] = factorRoots->values[j];
+                    }
+                    free(factorRoots->values); free(factorRoots);
+                }
+            }
+            freeFactorization(&factorization);
+            //The roots come in the order of the factors, they are sorted like the ones of a single factor
+            if (x) qsort(x->values, x->size, sizeof(double), compareRoots);
+            return x;
+        }
+        freeFactorization(&factorization);
+    }
     if (F.highestDegree > 0) {
         Solutions *x = malloc(sizeof(Solutions));
         *x = (Solutions) {F.highestDegree, malloc(F.highestDegree * sizeof(double))};
@@ -258,8 +789,6 @@ Solutions *solve(Polynomial F) {
             double root = IMAGINARY, delta;
             if (temp.coefficient[0] == 0) { //If the lowest coefficient is 0, it is a root of the polynomial
                 root = 0;
-            } else if (i > 0 && absolute(apply(temp, x->values[i-1])) < 1e-5) { //If a root as a multiplicity > 1
-                root = x->values[i-1];
             } else if (temp.highestDegree == 1) { //x = -c/b
                 root = -temp.coefficient[0] / temp.coefficient[1];
             } else if (temp.highestDegree == 2) { //x = (-b^2 +/- sqrt(delta))/(2a)
@@ -272,32 +801,18 @@ Solutions *solve(Polynomial F) {
                     root = (-temp.coefficient[1] + rootOfDelta) / (2 * temp.coefficient[2]);
                     temp = syntheticDivision(temp, x->values[i]); i++;
                 }
-            } else if (temp.highestDegree == 4) {
-                double a0 = temp.coefficient[4], a1 = temp.coefficient[3], a2 = temp.coefficient[2], a3 = temp.coefficient[1], a4 = temp.coefficient[0];
-                //Evident roots: 1 and −1 and −k
-                if (a0 + a1 + a2 + a3 + a4 == 0) root = 1;
-                else if (a0 + a2 + a4 == a1 + a2) root = -1;
-                else if (a4 == a3 * (a1 / a0)) root = -a1 / a0;
-                //Biquadratic equations
-                else if (a3 == a1 == 0) {
-                    Polynomial biquadraticForm = {NULL, (double[]) {a4, a2, a0}, 2};
-                    Solutions *biquadraticSolutions = solve(biquadraticForm);
-                    if (biquadraticSolutions) {
-                        x->values[i] = biquadraticSolutions->values[0];
-                        root = biquadraticSolutions->values[1];
-                        temp = syntheticDivision(temp, x->values[i]); i++;
-                    }
-                //Converting to a depressed quartic
-                } else if (a3 != 0) {
-                    Solutions *depressedSolutions = solve(depress(temp));
-                    if (depressedSolutions) {
-                        //We use reverse substitution
-                        for (int j = 0; j < depressedSolutions->size; j++) depressedSolutions->values[i] -= a1 / (4 * a0);
-                        return depressedSolutions;
-                    }
-                } else root = newtonMethod(temp);
-            } else { //Degree higher than 4
-                root = newtonMethod(temp);
+            } else { //Degree higher than 2, the depressed form centers the roots on 0, they are isolated then refined
+                double shift;
+                Polynomial depressedForm = depress(temp, &shift);
+                Intervals intervals = isolateRealRoots(depressedForm);
+                if (intervals.size < temp.highestDegree) { //Some roots are complex
+                    free(intervals.values); free(x->values); free(x); freePolynomial(&depressedForm);
+                    return NULL;
+                }
+                Polynomial fPrime = derive(depressedForm);
+                for (int j = 0; j < intervals.size; j++) x->values[i + j] = roundPreciseDouble(refineRoot(depressedForm, fPrime, intervals.values[j]) + shift);
+                free(intervals.values); freePolynomial(&fPrime); freePolynomial(&depressedForm);
+                return x;
             }
             if (root == IMAGINARY) return NULL;
             x->values[i] = roundPreciseDouble(root);
@@ -309,10 +824,292 @@ Solutions *solve(Polynomial F) {
 
 void printSolutions(Solutions *x) {
     if (x && x->size > 0) {
-        printf("{%1.2lf", x->values[0]);
-        for (int i = 1; i < x->size; i++) printf(", %1.2lf", x->values[i]);
-        printf("}\n");
-    } else printf("No solutions or some are complex numbers\n");
+        writeText("{"); writeNumber(x->values[0], 2);
+        for (int i = 1; i < x->size; i++) {
+            writeText(", "); writeNumber(x->values[i], 2);
+        }
+        writeText("}\n");
+    } else writeText("No solutions or some are complex numbers\n");
+}
+
+Polynomial toSparsePolynomial(Polynomial F) {
+    if (isSparse(F) || F.highestDegree < 0) return F;
+    int nbTerms = 0;
+    for (int i = 0; i <= F.highestDegree; i++) if (F.coefficient[i] != 0) nbTerms++;
+    if (nbTerms == 0) return newPolynomial(0); //The null polynomial stays dense
+    Polynomial sparse = newSparsePolynomial(nbTerms);
+    for (int i = 0, j = 0; i <= F.highestDegree; i++) {
+        if (F.coefficient[i] != 0) {
+            sparse.coefficient[j] = F.coefficient[i];
+            sparse.exponent[j++] = i;
+        }
+    }
+    sparse.highestDegree = sparse.exponent[nbTerms - 1];
+    sparse.name = F.name;
+    return sparse;
+}
+
+Polynomial toDensePolynomial(Polynomial F) {
+    if (!isSparse(F)) return F;
+    Polynomial dense = newPolynomial(F.highestDegree);
+    for (int i = 0; i < F.nbTerms; i++) dense.coefficient[F.exponent[i]] = F.coefficient[i];
+    dense.name = F.name;
+    return dense;
+}
+
+Polynomial adaptPolynomialForm(Polynomial F) {
+    if (F.highestDegree < 0) return F;
+    if (isSparse(F)) {
+        if (F.highestDegree < SPARSE_MIN_DEGREE || F.nbTerms * SPARSE_MAX_DENSITY > F.highestDegree + 1) {
+            Polynomial dense = toDensePolynomial(F);
+            freePolynomial(&F);
+            return dense;
+        }
+    } else if (F.highestDegree >= SPARSE_MIN_DEGREE) {
+        int nbTerms = 0;
+        for (int i = 0; i <= F.highestDegree; i++) if (F.coefficient[i] != 0) nbTerms++;
+        if (nbTerms > 0 && nbTerms * SPARSE_MAX_DENSITY <= F.highestDegree + 1) {
+            Polynomial sparse = toSparsePolynomial(F);
+            freePolynomial(&F);
+            return sparse;
+        }
+    }
+    return F;
+}
+
+/**
+ * Add a term at the end of a sparse polynomial
+ * This function append a term to a sparse polynomial being built in increasing order of exponents, growing its arrays if needed
+ * @param F - The sparse polynomial being built
+ * @param capacity - Number of terms that can currently be stored in F
+ * @param coefficient - Coefficient of the term
+ * @param exponent - Exponent of the term
+ */
+void appendSparseTerm(Polynomial *F, int *capacity, double coefficient, int exponent) {
+    if (coefficient == 0) return;
+    if (F->nbTerms == *capacity) {
+        *capacity *= 2;
+        F->coefficient = temporaryRealloc(F->coefficient, *capacity * sizeof(double));
+        F->exponent = temporaryRealloc(F->exponent, *capacity * sizeof(int));
+    }
+    F->coefficient[F->nbTerms] = coefficient;
+    F->exponent[F->nbTerms++] = exponent;
+}
+
+/**
+ * Close a sparse polynomial
+ * This function set the degree of a sparse polynomial once all terms are added, an empty result becomes the null dense polynomial
+ * @param F - The sparse polynomial built
+ * @return The finished polynomial
+ */
+Polynomial closeSparsePolynomial(Polynomial F) {
+    if (F.nbTerms == 0) {
+        freePolynomial(&F);
+        return newPolynomial(0);
+    }
+    F.highestDegree = F.exponent[F.nbTerms - 1];
+    return F;
+}
+
+Polynomial sparseAdd(Polynomial F, Polynomial G, int sign) {
+    if (!isSparse(F) || !isSparse(G)) { //One of them is the null polynomial
+        if (isSparse(F)) return copyPolynomial(F);
+        else if (isSparse(G)) return sparseMultiply(G, (Polynomial) {NULL, (double[]) {sign}, 0, (int[]) {0}, 1});
+        else return newPolynomial(0);
+    }
+    int capacity = F.nbTerms + G.nbTerms;
+    Polynomial output = newSparsePolynomial(capacity); output.nbTerms = 0;
+    int i = 0, j = 0;
+    while (i < F.nbTerms || j < G.nbTerms) {
+        if (j >= G.nbTerms || (i < F.nbTerms && F.exponent[i] < G.exponent[j])) {
+            appendSparseTerm(&output, &capacity, F.coefficient[i], F.exponent[i]); i++;
+        } else if (i >= F.nbTerms || G.exponent[j] < F.exponent[i]) {
+            appendSparseTerm(&output, &capacity, sign * G.coefficient[j], G.exponent[j]); j++;
+        } else {
+            appendSparseTerm(&output, &capacity, F.coefficient[i] + sign * G.coefficient[j], F.exponent[i]); i++; j++;
+        }
+    }
+    return closeSparsePolynomial(output);
+}
+
+Polynomial sparseMultiply(Polynomial F, Polynomial G) {
+    if (!isSparse(F) || !isSparse(G)) return newPolynomial(0); //One of them is the null polynomial
+    //Iterate over the smallest polynomial in the heap
+    if (F.nbTerms > G.nbTerms) {
+        Polynomial temp = F; F = G; G = temp;
+    }
+    //Heap of the next term of G to multiply with each term of F, ordered by resulting exponent
+    int heapSize = F.nbTerms, *heap = malloc(heapSize * sizeof(int)), *nextTerm = calloc(F.nbTerms, sizeof(int));
+    for (int i = 0; i < heapSize; i++) heap[i] = i; //F.exponent is increasing, so this is already a valid heap
+    int capacity = F.nbTerms + G.nbTerms;
+    Polynomial output = newSparsePolynomial(capacity); output.nbTerms = 0;
+    int currentExponent = -1; double currentCoefficient = 0;
+    while (heapSize > 0) {
+        int i = heap[0], exponent = F.exponent[i] + G.exponent[nextTerm[i]];
+        if (exponent != currentExponent) {
+            appendSparseTerm(&output, &capacity, currentCoefficient, currentExponent);
+            currentExponent = exponent; currentCoefficient = 0;
+        }
+        currentCoefficient += F.coefficient[i] * G.coefficient[nextTerm[i]];
+        //Move to the next term of G for this term of F, or remove it from the heap
+        if (++nextTerm[i] == G.nbTerms) heap[0] = heap[--heapSize];
+        //Sift down the root
+        for (int parent = 0, child = 1; child < heapSize; parent = child, child = 2 * parent + 1) {
+            if (child + 1 < heapSize && F.exponent[heap[child + 1]] + G.exponent[nextTerm[heap[child + 1]]] < F.exponent[heap[child]] + G.exponent[nextTerm[heap[child]]]) child++;
+            if (F.exponent[heap[parent]] + G.exponent[nextTerm[heap[parent]]] <= F.exponent[heap[child]] + G.exponent[nextTerm[heap[child]]]) break;
+            int temp = heap[parent]; heap[parent] = heap[child]; heap[child] = temp;
+        }
+    }
+    appendSparseTerm(&output, &capacity, currentCoefficient, currentExponent);
+    free(heap); free(nextTerm);
+    return closeSparsePolynomial(output);
+}
+
+Polynomial sparseDerive(Polynomial F) {
+    if (!isSparse(F)) return derive(F);
+    int capacity = F.nbTerms;
+    Polynomial FPrime = newSparsePolynomial(capacity); FPrime.nbTerms = 0;
+    for (int i = 0; i < F.nbTerms; i++) {
+        if (F.exponent[i] > 0) appendSparseTerm(&FPrime, &capacity, F.coefficient[i] * F.exponent[i], F.exponent[i] - 1);
+    }
+    return closeSparsePolynomial(FPrime);
+}
+
+double sparseApply(Polynomial F, double x) {
+    if (!isSparse(F)) return apply(F, x);
+    double result = 0, powerOfX = power(x, F.exponent[0]);
+    for (int i = 0; i < F.nbTerms; i++) {
+        if (i > 0) powerOfX *= power(x, F.exponent[i] - F.exponent[i - 1]);
+        result += F.coefficient[i] * powerOfX;
+    }
+    return result;
+}
+
+SubproductTree newSubproductTree(const double *points, int nbPoints) {
+    SubproductTree tree = {0, NULL, NULL};
+    if (nbPoints < 1) return tree;
+    //Count the levels, the root is the only node of the last level
+    tree.nbLevels = 1;
+    for (int size = nbPoints; size > 1; size = (size + 1) / 2) tree.nbLevels++;
+    tree.sizes = malloc(tree.nbLevels * sizeof(int));
+    tree.levels = malloc(tree.nbLevels * sizeof(Polynomial *));
+    //Leaves are X - x_i
+    tree.sizes[0] = nbPoints;
+    tree.levels[0] = malloc(nbPoints * sizeof(Polynomial));
+    for (int i = 0; i < nbPoints; i++) {
+        tree.levels[0][i] = newPolynomial(1);
+        tree.levels[0][i].coefficient[0] = -points[i];
+        tree.levels[0][i].coefficient[1] = 1;
+    }
+    //Each node is the product of its 2 children, a node without sibling is carried to the next level
+    for (int level = 1; level < tree.nbLevels; level++) {
+        tree.sizes[level] = (tree.sizes[level - 1] + 1) / 2;
+        tree.levels[level] = malloc(tree.sizes[level] * sizeof(Polynomial));
+        for (int i = 0; i < tree.sizes[level]; i++) {
+            if (2 * i + 1 < tree.sizes[level - 1]) tree.levels[level][i] = pMultiply(tree.levels[level - 1][2 * i], tree.levels[level - 1][2 * i + 1]);
+            else tree.levels[level][i] = copyPolynomial(tree.levels[level - 1][2 * i]);
+        }
+    }
+    return tree;
+}
+
+void freeSubproductTree(SubproductTree *tree) {
+    if (tree) {
+        for (int level = 0; level < tree->nbLevels; level++) {
+            for (int i = 0; i < tree->sizes[level]; i++) freePolynomial(&tree->levels[level][i]);
+            free(tree->levels[level]);
+        }
+        free(tree->levels); free(tree->sizes);
+        tree->nbLevels = 0; tree->levels = NULL; tree->sizes = NULL;
+    }
+}
+
+/**
+ * Evaluate a polynomial on the leaves under a node of a subproduct tree
+ * This function reduce the polynomial modulo each child of the node and recurse, small remainders are evaluated directly
+ * @param F - Remainder of the polynomial for this node
+ * @param tree - The subproduct tree of the points
+ * @param level - Level of the node
+ * @param index - Index of the node in its level
+ * @param points - The points of the tree
+ * @param values - Array where the values are written
+ */
+void evaluateUnderNode(Polynomial F, SubproductTree *tree, int level, int index, const double *points, double *values) {
+    int first = index << level, last = (index + 1) << level;
+    if (last > tree->sizes[0]) last = tree->sizes[0];
+    if (level == 0 || F.highestDegree < MULTIPOINT_DIRECT_DEGREE) { //Direct evaluation is cheaper for small remainders
+        for (int i = first; i < last; i++) values[i] = apply(F, points[i]);
+        return;
+    }
+    for (int child = 2 * index; child <= 2 * index + 1 && child < tree->sizes[level - 1]; child++) {
+        Polynomial remainder;
+        pDivideWithRemainder(F, tree->levels[level - 1][child], NULL, &remainder);
+        evaluateUnderNode(remainder, tree, level - 1, child, points, values);
+        freePolynomial(&remainder);
+    }
+}
+
+double *multipointEvaluate(Polynomial F, const double *points, int nbPoints) {
+    if (nbPoints < 1 || F.highestDegree < 0) return NULL;
+    double *values = malloc(nbPoints * sizeof(double));
+    F = toDensePolynomial(F);
+    if (F.highestDegree < MULTIPOINT_DIRECT_DEGREE || nbPoints < MULTIPOINT_DIRECT_DEGREE) {
+        for (int i = 0; i < nbPoints; i++) values[i] = apply(F, points[i]);
+        return values;
+    }
+    SubproductTree tree = newSubproductTree(points, nbPoints);
+    Polynomial remainder;
+    pDivideWithRemainder(F, tree.levels[tree.nbLevels - 1][0], NULL, &remainder);
+    evaluateUnderNode(remainder, &tree, tree.nbLevels - 1, 0, points, values);
+    freePolynomial(&remainder); freeSubproductTree(&tree);
+    //The remainders lose precision when the products of the tree have large coefficients, if sampled values disagree we fall back to direct evaluation
+    for (int i = 0; i < nbPoints; i += nbPoints / MULTIPOINT_CHECKED_POINTS + 1) {
+        double expected = apply(F, points[i]);
+        if (absolute(values[i] - expected) > 1e-9 * (1 + absolute(expected))) {
+            for (int j = 0; j < nbPoints; j++) values[j] = apply(F, points[j]);
+            break;
+        }
+    }
+    return values;
+}
+
+Polynomial interpolate(const double *xs, const double *ys, int nbPoints) {
+    if (nbPoints < 1) return nullPolynomial;
+    SubproductTree tree = newSubproductTree(xs, nbPoints);
+    //Weights y_i / M'(x_i) with M the product of all X - x_i
+    Polynomial MPrime = derive(tree.levels[tree.nbLevels - 1][0]);
+    double *weights = multipointEvaluate(MPrime, xs, nbPoints);
+    freePolynomial(&MPrime);
+    Polynomial *current = malloc(nbPoints * sizeof(Polynomial));
+    for (int i = 0; i < nbPoints; i++) {
+        if (weights[i] == 0) { //2 identical abscissas
+            for (int j = 0; j < i; j++) freePolynomial(&current[j]);
+            free(current); free(weights); freeSubproductTree(&tree);
+            return nullPolynomial;
+        }
+        current[i] = newPolynomial(0);
+        current[i].coefficient[0] = ys[i] / weights[i];
+    }
+    //Combine up the tree, a node gets left * M_right + right * M_left
+    for (int level = 1; level < tree.nbLevels; level++) {
+        for (int i = 0; i < tree.sizes[level]; i++) {
+            if (2 * i + 1 < tree.sizes[level - 1]) {
+                Polynomial left = pMultiply(current[2 * i], tree.levels[level - 1][2 * i + 1]);
+                Polynomial right = pMultiply(current[2 * i + 1], tree.levels[level - 1][2 * i]);
+                freePolynomial(&current[2 * i]); freePolynomial(&current[2 * i + 1]);
+                current[i] = pAdd(left, right);
+                freePolynomial(&left); freePolynomial(&right);
+            } else current[i] = current[2 * i];
+        }
+    }
+    Polynomial result = current[0];
+    //Remove the rounding errors left on the coefficients that should be null
+    double highestValue = 0;
+    for (int i = 0; i <= result.highestDegree; i++) if (absolute(result.coefficient[i]) > highestValue) highestValue = absolute(result.coefficient[i]);
+    for (int i = 0; i <= result.highestDegree; i++) if (absolute(result.coefficient[i]) < highestValue * 1e-12) result.coefficient[i] = 0;
+    eliminateNullCoefficients(&result);
+    free(current); free(weights); freeSubproductTree(&tree);
+    return result;
 }
 
 Polynomial variableToPolynomial(Variable variable) {
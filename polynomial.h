@@ -10,7 +10,18 @@
 #include "variable.h"
 
 #define nullPolynomial (Polynomial) {NULL, NULL, -1} ///New null polynomial
-#define highestCoefficient(F) F.coefficient[F.highestDegree]
+#define highestCoefficient(F) F.coefficient[F.highestDegree] ///Highest coefficient of a dense polynomial
+#define isSparse(F) ((F).exponent != NULL) ///Verify if a polynomial is stored in sparse form
+
+#define SPARSE_MIN_DEGREE 64 ///Lowest degree from which a polynomial can be stored in sparse form
+#define SPARSE_MAX_DENSITY 4 ///A polynomial is stored in sparse form if it has less than 1 term every SPARSE_MAX_DENSITY powers
+#define KARATSUBA_THRESHOLD 32 ///Degree from which dense polynomials are multiplied with the Karatsuba method
+#define FAST_DIVISION_THRESHOLD 64 ///Degree from which polynomials are divided with Newton iterations
+#define MULTIPOINT_DIRECT_DEGREE 16 ///Degree under which a polynomial is evaluated directly at each point
+#define GCD_TOLERANCE 1e-9 ///Relative size under which a remainder is considered null when computing a GCD
+#define MULTIPOINT_CHECKED_POINTS 8 ///Number of values of a multipoint evaluation checked against a direct evaluation
+#define ISOLATION_MAX_DEPTH 100 ///Maximum number of bisections when isolating a real root
+#define REFINE_MAX_ITERATIONS 100 ///Maximum number of iterations when refining an isolated root
 
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 // Structures
@@ -18,13 +29,65 @@
 /**
  * @struct Polynomial
  * Structure representing a polynomial of any degree
+ * @note A polynomial can be stored in dense form (coefficient[i] is the coefficient of X^i) or in sparse form (coefficient[i] is the coefficient of X^exponent[i], with exponent sorted in increasing order and no null coefficient)
  */
 typedef struct {
     char *name; ///Name of the polynomial
     double *coefficient; ///Coefficients of the polynomial
     int highestDegree; ///Highest degree of the polynomial
+    int *exponent; ///Exponents of the terms in sparse form, NULL if the polynomial is dense
+    int nbTerms; ///Number of terms in sparse form
+    int *references; ///Number of holders sharing the coefficients (register), NULL for a temporary result
 } Polynomial;
 
+/**
+ * @struct SubproductTree
+ * Structure representing the products of (X - x_i) for a group of points, the leaves are on level 0 and the product of all of them is the root on the last level
+ * @note The node i of a level is the product of the nodes 2i and 2i + 1 of the level below, it covers the points from i * 2^level to (i + 1) * 2^level excluded
+ */
+typedef struct {
+    int nbLevels; ///Number of levels of the tree
+    int *sizes; ///Number of nodes on each level
+    Polynomial **levels; ///Nodes of each level
+} SubproductTree;
+
+/**
+ * @struct Factorization
+ * Structure representing a polynomial as a product of monic factors raised to a power
+ */
+typedef struct {
+    int size; ///Number of factors
+    Polynomial *factors; ///Monic factors
+    int *multiplicities; ///Power of each factor
+} Factorization;
+
+/**
+ * @struct SturmSequence
+ * Structure representing the Sturm sequence of a polynomial: F, F' then the negated remainders of the Euclidean algorithm
+ */
+typedef struct {
+    int size; ///Number of polynomials in the sequence
+    Polynomial *polynomials; ///Polynomials of the sequence
+} SturmSequence;
+
+/**
+ * @struct Interval
+ * Structure representing an interval of real values
+ */
+typedef struct {
+    double lower; ///Lower bound
+    double upper; ///Upper bound
+} Interval;
+
+/**
+ * @struct Intervals
+ * Structure representing a group of intervals
+ */
+typedef struct {
+    int size; ///Number of intervals
+    Interval *values; ///Intervals contained in array
+} Intervals;
+
 /**
  * @struct Solutions
  * Structure representing solutions linked to an equation
@@ -44,6 +107,15 @@ typedef struct {
  */
 Polynomial newPolynomial(int degree);
 
+/**
+ * Create a polynomial with a single term
+ * This function create the polynomial coefficient * X^power, in sparse form if its degree is high enough
+ * @param coefficient - Coefficient of the term
+ * @param power - Power of X
+ * @return created polynomial
+ */
+Polynomial monomial(double coefficient, int power);
+
 /**
  * Convert a string to a polynomial
  * This function return a polynomial created from a string
@@ -54,13 +126,47 @@ Polynomial newPolynomial(int degree);
  */
 Polynomial stringToPolynomial(const char *string);
 
+/**
+ * Create an empty sparse polynomial
+ * This function create a sparse polynomial able to contain the given number of terms, its degree must be set by the caller
+ * @param nbTerms - Number of terms of the polynomial to create
+ * @return created sparse polynomial
+ */
+Polynomial newSparsePolynomial(int nbTerms);
+
+/**
+ * Copy a polynomial
+ * This function returns a copy of a given polynomial in the same form
+ * @param F - The polynomial to copy
+ * @return The copy of the given polynomial
+ */
+Polynomial copyPolynomial(Polynomial F);
+
 /**
  * Free an existing polynomial
- * This function free an existing polynomial and change its pointer to NULL if it worked successfully
+ * This function free an existing polynomial and change its pointer to NULL if it worked successfully, shared
+ * coefficients are only freed by their last holder
  * @param F - The polynomial to free
  */
 void freePolynomial(Polynomial *F);
 
+/**
+ * Share a polynomial
+ * This function add a holder to the coefficients of a polynomial instead of copying them, each holder frees the
+ * polynomial once. Operations on polynomials never modify their operands, shared coefficients are never copied
+ * @param F - The polynomial to share
+ * @return the polynomial with the same coefficients, counting the new holder
+ */
+Polynomial sharePolynomial(Polynomial F);
+
+/**
+ * Keep a polynomial after the command
+ * This function copy on the heap a polynomial allocated in the arena of the command, other polynomials are returned as is
+ * @param F - The polynomial to keep
+ * @return polynomial whose coefficients outlive the command, with the same name
+ */
+Polynomial promotePolynomial(Polynomial F);
+
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 // Basic operator functions
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -91,10 +197,30 @@ Polynomial pMinus(Polynomial F, Polynomial G);
  */
 Polynomial pMultiply(Polynomial F, Polynomial G);
 
+/**
+ * Multiply polynomials with the Karatsuba method
+ * This function return the product of 2 dense polynomials in O(n^1.58) instead of O(n^2)
+ * @param F - first polynomial
+ * @param G - second polynomial
+ * @return F * G
+ */
+Polynomial pFastMultiply(Polynomial F, Polynomial G);
+
+/**
+ * Divide polynomials with remainder
+ * This function compute the quotient and remainder of the division of 2 polynomials, large divisions are done by inverting the reversed denominator with Newton iterations
+ * @param numerator - first polynomial
+ * @param denominator - second polynomial
+ * @param quotient - where the quotient is written, can be NULL
+ * @param remainder - where the remainder is written, can be NULL
+ * @return 1 if the division was done, 0 if the denominator is null
+ */
+char pDivideWithRemainder(Polynomial numerator, Polynomial denominator, Polynomial *quotient, Polynomial *remainder);
+
 /**
  * Divide polynomials
  * This function return the division of 2 polynomials using the long division method
- * @note If there is a remainder, it will be printed in the terminal but it won't be integrated in the result
+ * @note If there is a remainder not negligible compared to the numerator (see GCD_TOLERANCE), it will be printed in the terminal but it won't be integrated in the result
  * @param numerator - first polynomial
  * @param denominator - second polynomial
  * @return numerator / denominator
@@ -129,6 +255,73 @@ void printPolynomial(Polynomial F);
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 // Advanced operator functions
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Taylor shift of a polynomial
+ * This function return F(X + a) using repeated synthetic divisions, in O(n^2) additions and multiplications without any temporary polynomial
+ * @param F - The polynomial to shift
+ * @param a - The shift
+ * @return F(X + a)
+ */
+Polynomial taylorShift(Polynomial F, double a);
+
+/**
+ * Composition of polynomials
+ * This function return F(G(X)) by splitting F in halves recursively, F(G) = low(G) + G^(2^k) * high(G), the powers of G being computed once by squaring
+ * @param F - The outer polynomial
+ * @param G - The inner polynomial
+ * @return F(G(X))
+ */
+Polynomial compose(Polynomial F, Polynomial G);
+
+/**
+ * Depress a polynomial
+ * This function return the monic polynomial F(X + shift) / a with no term in X^(n-1), with a the highest coefficient of F and n its degree
+ * @note The roots of F are the roots of the depressed form plus the shift
+ * @param F - The polynomial to depress
+ * @param shift - Where the shift -b / (n * a) is written, b being the coefficient of X^(n-1)
+ * @return depressed form of F
+ */
+Polynomial depress(Polynomial F, double *shift);
+
+/**
+ * Monic polynomial
+ * This function return a copy of the given polynomial divided by its highest coefficient
+ * @param F - The polynomial to normalise
+ * @return F / highest coefficient of F
+ */
+Polynomial monicPolynomial(Polynomial F);
+
+/**
+ * Greatest common divisor of polynomials
+ * This function return the monic GCD of 2 polynomials using the Euclidean algorithm, a remainder negligible compared to the dividend (see GCD_TOLERANCE) is considered null
+ * @param F - first polynomial
+ * @param G - second polynomial
+ * @return gcd(F, G)
+ */
+Polynomial pGcd(Polynomial F, Polynomial G);
+
+/**
+ * Square-free decomposition of a polynomial
+ * This function decompose a polynomial in a product of square-free factors with their multiplicity using Yun's algorithm
+ * @note The highest coefficient of the polynomial isn't part of the decomposition since all factors are monic
+ * @param F - The polynomial to decompose
+ * @return factors of F with their multiplicities
+ */
+Factorization squareFreeDecomposition(Polynomial F);
+
+/**
+ * Free a factorization
+ * @param factorization - The factorization to free
+ */
+void freeFactorization(Factorization *factorization);
+
+/**
+ * Print a factorization
+ * This function print a factorization in the terminal in the form (F1)^m1 * (F2)^m2 ...
+ * @param factorization - The factorization to print
+ */
+void printFactorization(Factorization factorization);
+
 /**
  * Synthetic division of a polynomial
  * This function return a polynomial with 1 degree less than the given polynomial by dividing it by "X - <root>"
@@ -138,23 +331,110 @@ void printPolynomial(Polynomial F);
  */
 Polynomial syntheticDivision(Polynomial F, double root);
 
+/**
+ * Create the Sturm sequence of a polynomial
+ * @param F - The given polynomial
+ * @return Sturm sequence of F
+ */
+SturmSequence newSturmSequence(Polynomial F);
+
+/**
+ * Free a Sturm sequence
+ * @param sequence - The sequence to free
+ */
+void freeSturmSequence(SturmSequence *sequence);
+
+/**
+ * Sign changes of a Sturm sequence
+ * This function count the sign changes in a Sturm sequence evaluated at a given value, null values are ignored
+ * @note The number of distinct real roots of F in ]a, b] is signChanges(a) - signChanges(b)
+ * @param sequence - Sturm sequence of a polynomial
+ * @param x - The value to use
+ * @return number of sign changes
+ */
+int signChanges(SturmSequence sequence, double x);
+
+/**
+ * Bound of the roots of a polynomial
+ * This function return the Cauchy bound of a polynomial, all its roots have an absolute value strictly lower than it
+ * @param F - The given polynomial
+ * @return bound of the roots of F
+ */
+double rootBound(Polynomial F);
+
+/**
+ * Isolate the real roots of a polynomial
+ * This function bisect the interval given by the root bound, using the Sturm sequence to count the roots in each half, until each interval contain exactly one root
+ * @note Each distinct root gives one interval, a cluster of roots closer than ISOLATION_MAX_DEPTH bisections gives one interval per root
+ * @param F - The given polynomial
+ * @return disjoint intervals in increasing order, each containing one root
+ */
+Intervals isolateRealRoots(Polynomial F);
+
+/**
+ * Refine an isolated root
+ * This function apply the Newton Method safeguarded by bisection, a Newton step is only taken if it stays inside the interval and converges fast enough
+ * @param F - The given polynomial
+ * @param fPrime - Derivative of F
+ * @param interval - An interval containing exactly one root of F
+ * @return approximation of the root
+ */
+double refineRoot(Polynomial F, Polynomial fPrime, Interval interval);
+
 /**
  * Application of the Newton Method
- * This function apply the Newton Method to find a root of the given polynomial
+ * This function isolate the real roots of the given polynomial and refine the lowest one with a safeguarded Newton Method
  * @param F - The given polynomial
- * @return approximation of a root of the given polynomial
+ * @return approximation of a root of the given polynomial, IMAGINARY if it has no real root
  */
 double newtonMethod(Polynomial F);
 
 /**
  * Find the roots of a polynomial
  * This function return the roots of a given polynomial of any degree
+ * @note Polynomials with multiple roots are split in square-free factors first, each root is then repeated according to its multiplicity
  * @warning the roots must be reals
  * @param F - The polynomial to solve
  * @return roots of the polynomial
  */
 Solutions *solve(Polynomial F);
 
+/**
+ * Create the subproduct tree of a group of points
+ * @param points - The points x_i
+ * @param nbPoints - Number of points
+ * @return subproduct tree of the (X - x_i)
+ */
+SubproductTree newSubproductTree(const double *points, int nbPoints);
+
+/**
+ * Free a subproduct tree
+ * @param tree - The tree to free
+ */
+void freeSubproductTree(SubproductTree *tree);
+
+/**
+ * Evaluate a polynomial at several points
+ * This function evaluate a polynomial at all given points by reducing it down a subproduct tree of the points
+ * @note Some values are checked with a direct evaluation, if the tree lost too much precision all points are evaluated directly
+ * @param F - The polynomial to evaluate
+ * @param points - The points where F is evaluated
+ * @param nbPoints - Number of points
+ * @return array of the F(x_i)
+ */
+double *multipointEvaluate(Polynomial F, const double *points, int nbPoints);
+
+/**
+ * Interpolate a polynomial
+ * This function return the polynomial of lowest degree going through all given points using the subproduct tree of the abscissas (Lagrange interpolation)
+ * @warning The abscissas must be distinct, a null polynomial is returned otherwise
+ * @param xs - Abscissas of the points
+ * @param ys - Ordinates of the points
+ * @param nbPoints - Number of points
+ * @return interpolating polynomial
+ */
+Polynomial interpolate(const double *xs, const double *ys, int nbPoints);
+
 /**
  * Print a group of solutions
  * This function print a group of solutions in the terminal
@@ -162,6 +442,70 @@ Solutions *solve(Polynomial F);
  */
 void printSolutions(Solutions *x);
 
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Sparse form
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Convert a polynomial to sparse form
+ * This function return the sparse form of a given polynomial, only non null coefficients are kept
+ * @note If the polynomial is already sparse, it is returned as is
+ * @param F - The polynomial to convert
+ * @return sparse form of F
+ */
+Polynomial toSparsePolynomial(Polynomial F);
+
+/**
+ * Convert a polynomial to dense form
+ * This function return the dense form of a given polynomial, with a coefficient for every power of X
+ * @note If the polynomial is already dense, it is returned as is
+ * @param F - The polynomial to convert
+ * @return dense form of F
+ */
+Polynomial toDensePolynomial(Polynomial F);
+
+/**
+ * Choose the form of a polynomial
+ * This function convert a polynomial to the form best suited to its density and free the other form
+ * @param F - The polynomial to adapt
+ * @return F in sparse form if it has few terms for its degree, in dense form otherwise
+ */
+Polynomial adaptPolynomialForm(Polynomial F);
+
+/**
+ * Sum or subtract sparse polynomials
+ * This function merge the terms of 2 sparse polynomials
+ * @param F - first sparse polynomial
+ * @param G - second sparse polynomial
+ * @param sign - 1 to sum the polynomials, -1 to subtract G from F
+ * @return F + sign * G in sparse form
+ */
+Polynomial sparseAdd(Polynomial F, Polynomial G, int sign);
+
+/**
+ * Multiply sparse polynomials
+ * This function return the product of 2 sparse polynomials, the terms are produced in increasing order using a heap so that no dense intermediate is needed
+ * @param F - first sparse polynomial
+ * @param G - second sparse polynomial
+ * @return F * G in sparse form
+ */
+Polynomial sparseMultiply(Polynomial F, Polynomial G);
+
+/**
+ * Derive a sparse polynomial
+ * @param F - the sparse polynomial to derive
+ * @return F' in sparse form
+ */
+Polynomial sparseDerive(Polynomial F);
+
+/**
+ * Apply a sparse polynomial for a given value
+ * This function evaluate the polynomial term by term, computing the powers of x by squaring between consecutive exponents
+ * @param F - the given sparse polynomial
+ * @param x - the value to use
+ * @return F(x)
+ */
+double sparseApply(Polynomial F, double x);
+
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 // Variables interactions
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
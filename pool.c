@@ -0,0 +1,231 @@
+/**
+ * @file pool.c Functions on the pool
+ * @author Valentin Koeltgen
+ *
+ * This file contain the allocator of the values of matrices and polynomials: blocks are rounded up to size classes and
+ * the freed ones are kept by each thread to be reused, so that repeated calculations don't ask the system for memory
+ */
+
+#define ALLOCATION_IMPLEMENTATION
+#include "pool.h"
+#include "output.h"
+#include <pthread.h>
+#include <sys/mman.h>
+
+PoolStatistics poolStatistics = {0, 0, 0, 0, 0, 0};
+PoolList poolDepot[POOL_NB_CLASSES]; ///Free blocks given back by the threads
+pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER; ///Lock of the depot
+pthread_key_t poolKey; ///Key whose destructor give the blocks of an ending thread to the depot
+pthread_once_t poolKeyCreated = PTHREAD_ONCE_INIT;
+__thread PoolList poolCache[POOL_NB_CLASSES]; ///Free blocks of the thread
+__thread char poolCacheRegistered = 0; ///1 once the thread gives its blocks to the depot when it ends
+
+/**
+ * Size of a class
+ * @param sizeClass - The class
+ * @return number of bytes of the blocks of the class
+ */
+size_t classSize(int sizeClass) {
+    return (size_t) (sizeClass & 1 ? 96 : 64) << (sizeClass >> 1);
+}
+
+/**
+ * Class of a size
+ * Each power of 2 is split in 2 classes, so that a block wastes at most a third of its size
+ * @param size - Number of bytes
+ * @return smallest class holding the size
+ */
+int classOf(size_t size) {
+    if (size <= 64) return 0;
+    int power = 63 - __builtin_clzll(size - 1); //2^power < size <= 2^(power + 1)
+    return 2 * (power - 6) + (size <= (size_t) 3 << (power - 1) ? 1 : 2);
+}
+
+/**
+ * Header of a block
+ * @param block - The block
+ * @return header just before the values
+ */
+PoolBlock *headerOf(void *block) {
+    return (PoolBlock *) block - 1;
+}
+
+/**
+ * Count the use of the pool
+ * @param counter - The counter to change, shared by the threads
+ * @param change - Value to add
+ */
+void countPool(long long *counter, long long change) {
+    __atomic_fetch_add(counter, change, __ATOMIC_RELAXED);
+}
+
+/**
+ * Give the free blocks of the ending thread to the depot
+ * @param cache - The cache of the thread
+ */
+void releasePoolCache(void *cache) {
+    (void) cache;
+    pthread_mutex_lock(&poolLock);
+    for (int i = 0; i < POOL_NB_CLASSES; i++) {
+        while (poolCache[i].first) {
+            PoolBlock *header = poolCache[i].first;
+            poolCache[i].first = header->next;
+            header->next = poolDepot[i].first;
+            poolDepot[i].first = header;
+        }
+        poolDepot[i].size += poolCache[i].size;
+        poolCache[i].size = 0;
+    }
+    pthread_mutex_unlock(&poolLock);
+}
+
+void createPoolKey() {
+    pthread_key_create(&poolKey, releasePoolCache);
+}
+
+/**
+ * Map a block on its own
+ * Mapped pages are given filled with zeros, the large ones are backed by transparent huge pages
+ * @param size - Number of bytes
+ * @return the block
+ */
+void *mapBlock(size_t size) {
+    size_t mappedSize = size + sizeof(PoolBlock);
+    PoolBlock *header = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (header == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+    if (size >= POOL_HUGE_SIZE) madvise(header, mappedSize, MADV_HUGEPAGE);
+#endif
+    *header = (PoolBlock) {NULL, size, -1, 0, 0, {0}};
+    countPool(&poolStatistics.mapped, 1);
+    countPool(&poolStatistics.usedBytes, (long long) size);
+    countPool(&poolStatistics.allocatedBytes, (long long) size);
+    return header + 1;
+}
+
+/**
+ * Take a free block from a list
+ * @param list - The free blocks of a class
+ * @return the last freed block, NULL if the list is empty
+ */
+PoolBlock *takeBlock(PoolList *list) {
+    PoolBlock *header = list->first;
+    if (header) {
+        list->first = header->next;
+        list->size -= header->size;
+    }
+    return header;
+}
+
+/**
+ * Ask the system for a block of a class
+ * The blocks of the small classes are cut in a slab, the other ones are kept by the thread for the next allocations
+ * @param sizeClass - The class
+ * @return header of the block
+ */
+PoolBlock *newBlocks(int sizeClass) {
+    size_t size = classSize(sizeClass), stride = (sizeof(PoolBlock) + size + POOL_ALIGNMENT - 1) & ~(size_t) (POOL_ALIGNMENT - 1);
+    char carved = stride <= POOL_SLAB_SIZE / 8;
+    void *memory;
+    if (posix_memalign(&memory, POOL_ALIGNMENT, carved ? POOL_SLAB_SIZE : sizeof(PoolBlock) + size)) return NULL;
+    PoolBlock *header = memory;
+    *header = (PoolBlock) {NULL, size, sizeClass, carved, 0, {0}};
+    for (size_t offset = stride; carved && offset + stride <= POOL_SLAB_SIZE; offset += stride) {
+        PoolBlock *block = (PoolBlock *) ((char *) memory + offset);
+        *block = (PoolBlock) {poolCache[sizeClass].first, size, sizeClass, 1, 1, {0}};
+        poolCache[sizeClass].first = block;
+        poolCache[sizeClass].size += size;
+        countPool(&poolStatistics.heldBytes, (long long) size);
+    }
+    countPool(&poolStatistics.misses, 1);
+    return header;
+}
+
+/**
+ * Allocate a block of a class
+ * @param sizeClass - The class
+ * @return the block
+ */
+void *allocateBlock(int sizeClass) {
+    size_t size = classSize(sizeClass);
+    PoolBlock *header = takeBlock(&poolCache[sizeClass]);
+    if (!header) { //The depot is only locked when the thread has no block of the class
+        pthread_mutex_lock(&poolLock);
+        header = takeBlock(&poolDepot[sizeClass]);
+        pthread_mutex_unlock(&poolLock);
+    }
+    if (header) {
+        countPool(header->fresh ? &poolStatistics.misses : &poolStatistics.hits, 1);
+        countPool(&poolStatistics.heldBytes, -(long long) size);
+        header->fresh = 0;
+    } else if (!(header = newBlocks(sizeClass))) return NULL;
+    countPool(&poolStatistics.usedBytes, (long long) size);
+    countPool(&poolStatistics.allocatedBytes, (long long) size);
+    return header + 1;
+}
+
+void *poolMalloc(size_t size) {
+    if (size > POOL_MAX_SIZE) return mapBlock(size);
+    return allocateBlock(classOf(size));
+}
+
+void *poolCalloc(size_t number, size_t size) {
+    if (number * size > POOL_MAX_SIZE) return mapBlock(number * size);
+    char *block = allocateBlock(classOf(number * size));
+    for (size_t i = 0; block && i < number * size; i++) block[i] = 0;
+    return block;
+}
+
+void *poolRealloc(void *block, size_t size) {
+    if (!block) return poolMalloc(size);
+    PoolBlock *header = headerOf(block);
+    if (size <= header->size) return block;
+    char *moved = poolMalloc(size), *old = block;
+    for (size_t i = 0; moved && i < header->size; i++) moved[i] = old[i];
+    poolFree(block);
+    return moved;
+}
+
+void poolFree(void *block) {
+    if (!block) return;
+    PoolBlock *header = headerOf(block);
+    int sizeClass = header->sizeClass;
+    countPool(&poolStatistics.usedBytes, -(long long) header->size);
+    if (sizeClass < 0) {
+        munmap(header, header->size + sizeof(PoolBlock));
+        return;
+    }
+    if (!poolCacheRegistered) {
+        pthread_once(&poolKeyCreated, createPoolKey);
+        pthread_setspecific(poolKey, poolCache);
+        poolCacheRegistered = 1;
+    }
+    if (poolCache[sizeClass].size + header->size <= POOL_CACHE_SIZE) {
+        header->next = poolCache[sizeClass].first;
+        poolCache[sizeClass].first = header;
+        poolCache[sizeClass].size += header->size;
+        countPool(&poolStatistics.heldBytes, (long long) header->size);
+        return;
+    }
+    //The thread keeps enough blocks of this class, the block is shared with the other threads
+    pthread_mutex_lock(&poolLock);
+    size_t held = 0;
+    for (int i = 0; i < POOL_NB_CLASSES; i++) held += poolDepot[i].size;
+    char kept = header->carved || held + header->size <= POOL_DEPOT_SIZE;
+    if (kept) {
+        header->next = poolDepot[sizeClass].first;
+        poolDepot[sizeClass].first = header;
+        poolDepot[sizeClass].size += header->size;
+    }
+    pthread_mutex_unlock(&poolLock);
+    if (kept) countPool(&poolStatistics.heldBytes, (long long) header->size);
+    else free(header);
+}
+
+void printPoolStatistics() {
+    long long hits = __atomic_load_n(&poolStatistics.hits, __ATOMIC_RELAXED), misses = __atomic_load_n(&poolStatistics.misses, __ATOMIC_RELAXED);
+    writeFormat("%lld allocations, %.1f%% reused freed blocks, %lld mapped blocks\n", hits + misses,
+                hits + misses ? 100.0 * (double) hits / (double) (hits + misses) : 0.0, __atomic_load_n(&poolStatistics.mapped, __ATOMIC_RELAXED));
+    writeFormat("%.3f MB in use, %.3f MB held for the next allocations\n", (double) __atomic_load_n(&poolStatistics.usedBytes, __ATOMIC_RELAXED) / 1e6,
+                (double) __atomic_load_n(&poolStatistics.heldBytes, __ATOMIC_RELAXED) / 1e6);
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+/**
+ * @file pool.h Header file of pool.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_POOL_H
+#define LINEARALGEBRA_POOL_H
+
+#include <stdlib.h>
+
+#define POOL_ALIGNMENT 64 ///Alignment of the blocks, the size of a cache line and of the widest SIMD registers
+#define POOL_NB_CLASSES 31 ///Number of size classes, from 64 bytes to POOL_MAX_SIZE with 2 classes per power of 2
+#define POOL_MAX_SIZE ((size_t) 64 << 15) ///Largest size class, larger blocks are mapped on their own
+#define POOL_HUGE_SIZE POOL_MAX_SIZE ///Size from which a mapped block is backed by transparent huge pages
+#define POOL_SLAB_SIZE (1 << 16) ///Bytes asked to the system at once for the small classes, they are cut in blocks
+#define POOL_CACHE_SIZE (1 << 22) ///Most bytes of a size class kept by a thread, the next freed blocks go to the depot
+#define POOL_DEPOT_SIZE (1 << 28) ///Most bytes kept in the depot, the next freed blocks are given back to the system
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct PoolBlock
+ * Structure representing the header of a block, it is just before the values so that they stay aligned
+ */
+typedef struct PoolBlock {
+    struct PoolBlock *next; ///Next free block of the same class
+    size_t size; ///Number of bytes that can be used
+    int sizeClass; ///Class of the block, -1 for a mapped block
+    char carved; ///1 if the block was cut in a slab, it is never given back to the system
+    char fresh; ///1 while a block cut in a slab was never used
+    char padding[POOL_ALIGNMENT - sizeof(void *) - sizeof(size_t) - sizeof(int) - 2]; ///Keep the values aligned
+} PoolBlock;
+
+/**
+ * @struct PoolList
+ * Structure representing the free blocks of a size class
+ */
+typedef struct {
+    PoolBlock *first; ///Last freed block, it is reused first
+    size_t size; ///Number of bytes of the blocks
+} PoolList;
+
+/**
+ * @struct PoolStatistics
+ * Structure representing the use of the pool since the start
+ */
+typedef struct {
+    long long hits; ///Allocations served by a freed block
+    long long misses; ///Allocations asked to the system
+    long long mapped; ///Blocks mapped on their own
+    long long heldBytes; ///Bytes of the free blocks kept for the next allocations
+    long long usedBytes; ///Bytes of the blocks in use
+    long long allocatedBytes; ///Bytes of all the blocks allocated since the start
+} PoolStatistics;
+
+extern PoolStatistics poolStatistics; ///Use of the pool, updated by all threads
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Allocate a block
+ * The size is rounded up to its class, a block of the class freed by the thread is reused first, then one of the
+ * depot shared by the threads
+ * @param size - Number of bytes
+ * @return block aligned on POOL_ALIGNMENT bytes
+ */
+void *poolMalloc(size_t size);
+
+/**
+ * Allocate a block filled with zeros
+ * @param number - Number of elements
+ * @param size - Number of bytes of an element
+ * @return block aligned on POOL_ALIGNMENT bytes
+ */
+void *poolCalloc(size_t number, size_t size);
+
+/**
+ * Change the size of a block
+ * The block is kept when its class is large enough, it is moved otherwise
+ * @param block - The block, NULL to allocate a new one
+ * @param size - New number of bytes
+ * @return the resized block
+ */
+void *poolRealloc(void *block, size_t size);
+
+/**
+ * Free a block
+ * The block is kept by the thread for the next allocations of its class, a mapped block is unmapped
+ * @param block - The block, allocated by the pool
+ */
+void poolFree(void *block);
+
+/**
+ * Display the statistics of the pool
+ */
+void printPoolStatistics();
+
+#endif //LINEARALGEBRA_POOL_H
\ No newline at end of file
@@ -0,0 +1,179 @@
+/**
+ * @file profiler.c Functions on the profiler
+ * @author Valentin Koeltgen
+ *
+ * This file contain the measures of a profiled command: the clocks around its parse and its evaluation, the time of
+ * each kernel it calls, the bytes it allocates and the hardware counters of the processor when the system gives them
+ */
+
+#include "profiler.h"
+#include "parser.h"
+#include <errno.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+char profiling = 0;
+KernelProfile kernelProfiles[NB_KERNELS];
+const char *counterNames[NB_HARDWARE_COUNTERS] = {"cycles", "instructions", "cache misses"}; ///Names of the hardware counters
+
+/**
+ * Read a clock
+ * @param clock - The clock
+ * @return time of the clock in seconds
+ */
+double readClock(clockid_t clock) {
+    struct timespec time;
+    clock_gettime(clock, &time);
+    return (double) time.tv_sec + (double) time.tv_nsec / 1e9;
+}
+
+double wallTime() {
+    return readClock(CLOCK_MONOTONIC);
+}
+
+double cpuTime() {
+    return readClock(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+long long allocatedBytes() {
+    return __atomic_load_n(&poolStatistics.allocatedBytes, __ATOMIC_RELAXED) + commandArena.allocatedBytes;
+}
+
+/**
+ * Name of a kernel
+ * @param kernel - The kernel
+ * @return name of the kernel, the name of the function for the kernels of the functions
+ */
+const char *kernelName(int kernel) {
+    const char *names[KERNEL_FUNCTIONS] = {"matrix product", "pAdd", "pMultiply", "pLongDivide"};
+    return kernel < KERNEL_FUNCTIONS ? names[kernel] : functionNames[kernel - KERNEL_FUNCTIONS];
+}
+
+KernelProbe openKernel(int kernel) {
+    KernelProbe probe = {kernel, -1, traceBegin("kernel", kernelName(kernel), -1)};
+    //The recursive calls of a kernel are part of the first one
+    if (profiling && !kernelProfiles[kernel].depth++) probe.start = wallTime();
+    return probe;
+}
+
+void closeKernel(KernelProbe probe, double flops) {
+    traceEnd(probe.traced);
+    if (probe.start < 0) return;
+    KernelProfile *profile = &kernelProfiles[probe.kernel];
+    profile->depth = 0; //The recursive calls weren't timed, they are closed with the first one
+    profile->calls++;
+    profile->seconds += wallTime() - probe.start;
+    profile->flops += flops;
+}
+
+/**
+ * Open a hardware counter of the process
+ * The counter starts disabled, it counts the instructions of the user space of all the threads created after it
+ * @param counter - Index of the counter in counterNames
+ * @return descriptor of the counter, -1 if the system doesn't give it
+ */
+int openCounter(int counter) {
+#ifdef __linux__
+    unsigned long long configs[NB_HARDWARE_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+    struct perf_event_attr attributes = {0};
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = configs[counter];
+    attributes.disabled = 1;
+    attributes.inherit = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    //The counters share the processor with the other programs using them, they are scaled by their running time
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int) syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+#else
+    (void) counter;
+    return -1;
+#endif
+}
+
+/**
+ * Read a hardware counter and close it
+ * @param descriptor - Descriptor of the counter
+ * @return value of the counter, -1 if it never ran
+ */
+double closeCounter(int descriptor) {
+    double value = -1;
+#ifdef __linux__
+    unsigned long long values[3];
+    ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(descriptor, values, sizeof(values)) == sizeof(values) && values[2] > 0) {
+        value = (double) values[0] * (double) values[1] / (double) values[2];
+    }
+    close(descriptor);
+#else
+    (void) descriptor;
+#endif
+    return value;
+}
+
+Profile startProfile() {
+    Profile profile = {0, 0, 0, {-1, -1, -1}, NULL};
+    for (int i = 0; i < NB_KERNELS; i++) kernelProfiles[i] = (KernelProfile) {0, 0, 0, 0};
+    for (int i = 0; i < NB_HARDWARE_COUNTERS && !profile.counterError; i++) {
+        profile.counters[i] = openCounter(i);
+        if (profile.counters[i] >= 0) continue;
+        if (errno == EACCES || errno == EPERM) profile.counterError = "not permitted, see /proc/sys/kernel/perf_event_paranoid";
+        else if (errno == ENOENT || errno == EOPNOTSUPP) profile.counterError = "not supported by the processor";
+        else profile.counterError = "not available on this system";
+    }
+    if (profile.counterError) { //The counters are given together or not at all
+        for (int i = 0; i < NB_HARDWARE_COUNTERS; i++) if (profile.counters[i] >= 0) closeCounter(profile.counters[i]);
+    }
+#ifdef __linux__
+    else {
+        for (int i = 0; i < NB_HARDWARE_COUNTERS; i++) ioctl(profile.counters[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    profile.allocatedStart = allocatedBytes();
+    profile.cpuStart = cpuTime();
+    profile.wallStart = wallTime();
+    profiling = 1;
+    return profile;
+}
+
+void endProfile(Profile profile, double parseSeconds) {
+    double wallSeconds = wallTime() - profile.wallStart, cpuSeconds = cpuTime() - profile.cpuStart;
+    profiling = 0;
+    double counters[NB_HARDWARE_COUNTERS];
+    for (int i = 0; i < NB_HARDWARE_COUNTERS; i++) counters[i] = profile.counterError ? -1 : closeCounter(profile.counters[i]);
+    long long bytes = allocatedBytes() - profile.allocatedStart;
+    writeFormat("Parse : %.6f s\n", parseSeconds);
+    writeFormat("Evaluation : %.6f s\n", wallSeconds - parseSeconds);
+    double flops = 0;
+    char header = 0;
+    for (int i = 0; i < NB_KERNELS; i++) {
+        KernelProfile kernel = kernelProfiles[i];
+        if (!kernel.calls) continue;
+        if (!header++) writeText("Kernels (the time of a kernel includes the kernels it calls) :\n");
+        writeFormat("\t%s\t%lld call%s\t%.6f s", kernelName(i), kernel.calls, kernel.calls > 1 ? "s" : "", kernel.seconds);
+        if (kernel.flops > 0 && kernel.seconds > 0) writeFormat("\t%.3g flops\t%.3f GFLOPS", kernel.flops, kernel.flops / kernel.seconds / 1e9);
+        writeText("\n");
+        flops += kernel.flops;
+    }
+    writeFormat("Total : %.6f s wall, %.6f s CPU", wallSeconds, cpuSeconds);
+    if (flops > 0) writeFormat(", %.3g estimated flops (%.3f GFLOPS)", flops, wallSeconds > 0 ? flops / wallSeconds / 1e9 : 0);
+    writeFormat(", %.3f MB allocated\n", (double) bytes / 1e6);
+    if (profile.counterError) {
+        writeFormat("Hardware counters : %s\n", profile.counterError);
+        return;
+    }
+    writeText("Hardware counters :");
+    for (int i = 0; i < NB_HARDWARE_COUNTERS; i++) {
+        if (counters[i] < 0) writeFormat(" %s not counted%s", counterNames[i], i < NB_HARDWARE_COUNTERS - 1 ? "," : "");
+        else writeFormat(" %.0f %s%s", counters[i], counterNames[i], i < NB_HARDWARE_COUNTERS - 1 ? "," : "");
+    }
+    if (counters[0] > 0 && counters[1] >= 0) writeFormat(" (%.2f instructions per cycle)", counters[1] / counters[0]);
+    writeText("\n");
+}
\ No newline at end of file
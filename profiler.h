@@ -0,0 +1,115 @@
+/**
+ * @file profiler.h Header file of profiler.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_PROFILER_H
+#define LINEARALGEBRA_PROFILER_H
+
+#include "tracer.h"
+
+#define KERNEL_MULTIPLY 0 ///Matrix product
+#define KERNEL_P_ADD 1 ///Sum or difference of polynomials
+#define KERNEL_P_MULTIPLY 2 ///Product of polynomials
+#define KERNEL_P_DIVIDE 3 ///Long division of polynomials
+#define KERNEL_FUNCTIONS 4 ///Kernel of the first function, the kernel of a function is KERNEL_FUNCTIONS + its index
+#define NB_KERNELS 32 ///Most kernels, at least KERNEL_FUNCTIONS + NB_FUNCTIONS
+#define NB_HARDWARE_COUNTERS 3 ///Cycles, instructions and cache misses
+
+extern char profiling; ///1 while a command is profiled, the kernels are only timed then
+
+///Start timing a kernel, a single test when no command is profiled or traced
+#define startKernel(kernel) (profiling | tracing ? openKernel(kernel) : (KernelProbe) {-1, 0, 0})
+///Stop timing a kernel, the flops are only estimated when it was probed
+#define endKernel(probe, flops) if ((probe).kernel >= 0) closeKernel(probe, flops)
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct KernelProbe
+ * Structure representing a running kernel
+ */
+typedef struct {
+    int kernel; ///The kernel, -1 if it isn't probed
+    double start; ///Time of the start in seconds, -1 if it isn't timed
+    char traced; ///1 if the begin of the kernel was traced
+} KernelProbe;
+
+/**
+ * @struct KernelProfile
+ * Structure representing the calls of a kernel during the profiled command
+ */
+typedef struct {
+    long long calls; ///Number of calls, a call made by a running call of the same kernel is part of it
+    double seconds; ///Wall time of the calls
+    double flops; ///Estimated floating point operations, 0 if they can't be estimated from the sizes
+    int depth; ///Number of running calls
+} KernelProfile;
+
+/**
+ * @struct Profile
+ * Structure representing the measures of a profiled command
+ */
+typedef struct {
+    double wallStart; ///Wall time at the start in seconds
+    double cpuStart; ///Processor time of the process at the start in seconds
+    long long allocatedStart; ///Bytes allocated before the start
+    int counters[NB_HARDWARE_COUNTERS]; ///Descriptors of the hardware counters, -1 if a counter isn't available
+    const char *counterError; ///Reason why the hardware counters are unavailable, NULL if they are
+} Profile;
+
+extern KernelProfile kernelProfiles[NB_KERNELS]; ///Calls of each kernel during the profiled command
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Monotonic time
+ * @return seconds since an unspecified start, never going backward
+ */
+double wallTime();
+
+/**
+ * Processor time of the process
+ * @return seconds of processor time used by all the threads of the process
+ */
+double cpuTime();
+
+/**
+ * Bytes allocated since the start
+ * @return bytes of the blocks allocated by the pool and in the chunks of the arena
+ */
+long long allocatedBytes();
+
+/**
+ * Start timing and tracing a kernel, use startKernel instead
+ * @param kernel - The kernel
+ * @return the probe to give to endKernel, it isn't timed if the kernel is already running
+ */
+KernelProbe openKernel(int kernel);
+
+/**
+ * Stop timing and tracing a kernel, use endKernel instead
+ * @param probe - Probe returned at the start of the kernel
+ * @param flops - Estimated floating point operations of the call, 0 if unknown
+ */
+void closeKernel(KernelProbe probe, double flops);
+
+/**
+ * Start profiling a command
+ * This function reset the kernel profiles, start the hardware counters when the system gives them and read the clocks
+ * @return measures at the start
+ */
+Profile startProfile();
+
+/**
+ * Stop profiling a command and display its measures
+ * This function display the wall and processor times of the parse and of the evaluation, the time and the estimated
+ * flops of each kernel, the allocated bytes and the hardware counters
+ * @param profile - Measures at the start
+ * @param parseSeconds - Wall time of the parse
+ */
+void endProfile(Profile profile, double parseSeconds);
+
+#endif //LINEARALGEBRA_PROFILER_H
\ No newline at end of file
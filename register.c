@@ -7,14 +7,32 @@
 
 #include "register.h"
 
+///Names of the types of objects kept in a register
+const char *typeNames[] = {"polynomial", "matrix", "variable"};
+
+/**
+ * Release an object of a register
+ * The values of a matrix or a polynomial are only freed if no other name share them
+ * @param object - The object to release, it becomes unused
+ */
+void releaseObject(Object *object) {
+    if (object->type == POLYNOMIAL) {
+        free(object->any.polynomial.name);
+        freePolynomial(&object->any.polynomial);
+    } else if (object->type == MATRIX) {
+        free(object->any.matrix.name);
+        freeMatrix(&object->any.matrix);
+    } else if (object->type == VARIABLE) freeVariable(&object->any.variable);
+    *object = newObject;
+}
+
 void freeRegisterContent(Register *aRegister) {
     if (aRegister) {
-        free(aRegister->listOfPolynomials); aRegister->listOfPolynomials = NULL;
-        aRegister->sizes[POLYNOMIAL] = 0;
-        free(aRegister->listOfMatrices); aRegister->listOfMatrices = NULL;
-        aRegister->sizes[MATRIX] = 0;
-        free(aRegister->listOfVariables); aRegister->listOfVariables = NULL;
-        aRegister->sizes[VARIABLE] = 0;
+        for (int i = 0; i < aRegister->nbNames; i++) releaseObject(&aRegister->entries[i].object);
+        aRegister->sizes[POLYNOMIAL] = aRegister->sizes[MATRIX] = aRegister->sizes[VARIABLE] = 0;
+        //Every name changed
+        aRegister->version++;
+        for (int i = 0; i < aRegister->nbNames; i++) aRegister->entries[i].version = aRegister->version;
     }
 }
 
@@ -26,139 +44,155 @@ Object checkObject(Object input) {
     else return input;
 }
 
-Object searchObject(Register *aRegister, const char *name) {
-    if (aRegister->listOfPolynomials) {
-        for (int i = 0; i < aRegister->sizes[POLYNOMIAL]; i++) {
-            if (!shorterString(aRegister->listOfPolynomials[i].name, firstWord(name))) {
-                return (Object) {POLYNOMIAL, .any.polynomial = aRegister->listOfPolynomials[i]};
-            }
-        }
-    }
-    if (aRegister->listOfMatrices) {
-        for (int i = 0; i < aRegister->sizes[MATRIX]; i++) {
-            if (!shorterString(aRegister->listOfMatrices[i].name, firstWord(name))) {
-                return (Object) {MATRIX, .any.matrix = aRegister->listOfMatrices[i]};
-            }
+/**
+ * Name of an object
+ * @param object - The object
+ * @return name of the object, NULL if it has none
+ */
+char *nameOf(Object object) {
+    if (object.type == POLYNOMIAL) return object.any.polynomial.name;
+    else if (object.type == MATRIX) return object.any.matrix.name;
+    else if (object.type == VARIABLE) return object.any.variable.name;
+    return NULL;
+}
+
+/**
+ * Length of a name
+ * A name ends at the first space or equal sign, like the first word of a command
+ * @param name - The name, leading spaces are skipped
+ * @param first - Return the index of the first character of the name
+ * @return number of characters of the name
+ */
+int nameLength(const char *name, int *first) {
+    int i = 0;
+    while (name[i] == ' ') i++;
+    *first = i;
+    while (name[i] && name[i] != ' ' && name[i] != '=') i++;
+    return i - *first;
+}
+
+/**
+ * Find the entry of a name
+ * @param aRegister - The register containing the name
+ * @param name - The name
+ * @param size - Number of characters of the name
+ * @param hash - Hash of the name
+ * @return place of the entry in the hash table, or the empty place where it would be added
+ */
+int findPlace(Register *aRegister, const char *name, int size, unsigned long long hash) {
+    int place = (int) (hash & (aRegister->capacity - 1));
+    while (aRegister->places[place] >= 0) {
+        RegisterEntry *entry = &aRegister->entries[aRegister->places[place]];
+        if (entry->hash == hash) {
+            int i = 0;
+            while (i < size && entry->name[i] == name[i]) i++;
+            if (i == size && !entry->name[i]) return place;
         }
+        place = (place + 1) & (aRegister->capacity - 1);
     }
-    if (aRegister->listOfVariables) {
-        for (int i = 0; i < aRegister->sizes[VARIABLE]; i++) {
-            if (!shorterString(aRegister->listOfVariables[i].name, firstWord(name))) {
-                return (Object) {VARIABLE, .any.variable = aRegister->listOfVariables[i]};
-            }
+    return place;
+}
+
+/**
+ * Search for the entry of a name
+ * @param aRegister - The register containing the name
+ * @param name - The name
+ * @return entry of the name, NULL if it was never assigned
+ */
+RegisterEntry *searchEntry(Register *aRegister, const char *name) {
+    if (!aRegister->nbNames || !name) return NULL;
+    int first, size = nameLength(name, &first);
+    int place = findPlace(aRegister, name + first, size, hashContent(name + first, size));
+    return aRegister->places[place] >= 0 ? &aRegister->entries[aRegister->places[place]] : NULL;
+}
+
+/**
+ * Add a name to a register
+ * The table doubles when half of its places are used, so that a name is found in a few probes
+ * @param aRegister - The register
+ * @param name - The name
+ * @return entry of the name, the existing one if it was already assigned
+ */
+RegisterEntry *addEntry(Register *aRegister, const char *name) {
+    RegisterEntry *entry = searchEntry(aRegister, name);
+    if (entry) return entry;
+    if (2 * (aRegister->nbNames + 1) > aRegister->capacity) {
+        free(aRegister->places);
+        aRegister->capacity = aRegister->capacity ? 2 * aRegister->capacity : REGISTER_CAPACITY;
+        aRegister->places = malloc(aRegister->capacity * sizeof(int));
+        for (int i = 0; i < aRegister->capacity; i++) aRegister->places[i] = -1;
+        for (int i = 0; i < aRegister->nbNames; i++) {
+            RegisterEntry *moved = &aRegister->entries[i];
+            aRegister->places[findPlace(aRegister, moved->name, length(moved->name), moved->hash)] = i;
         }
+        //Entries are never removed, half of the table is enough for them
+        aRegister->entries = realloc(aRegister->entries, aRegister->capacity / 2 * sizeof(RegisterEntry));
     }
-    return newObject;
+    int first, size = nameLength(name, &first);
+    unsigned long long hash = hashContent(name + first, size);
+    aRegister->places[findPlace(aRegister, name + first, size, hash)] = aRegister->nbNames;
+    aRegister->entries[aRegister->nbNames] = (RegisterEntry) {extractUpToIndex(name + first, size), hash, 0, newObject};
+    return &aRegister->entries[aRegister->nbNames++];
+}
+
+Object searchObject(Register *aRegister, const char *name) {
+    RegisterEntry *entry = searchEntry(aRegister, name);
+    return entry ? entry->object : newObject;
+}
+
+int versionOf(Register *aRegister, const char *name) {
+    RegisterEntry *entry = searchEntry(aRegister, name);
+    return entry ? entry->version : 0;
 }
 
 void deleteFromRegister(Register *aRegister, Object toDelete) {
-    if (toDelete.type == POLYNOMIAL) {
-        for (int i = 0; i < aRegister->sizes[POLYNOMIAL]; i++) {
-            if (!shorterString(aRegister->listOfPolynomials[i].name, toDelete.any.polynomial.name)) {
-                freePolynomial(&aRegister->listOfPolynomials[i]);
-                for (int j = i; j < aRegister->sizes[POLYNOMIAL] - 1; j++) aRegister->listOfPolynomials[j] = aRegister->listOfPolynomials[j + 1];
-                if (--aRegister->sizes[POLYNOMIAL] == 0) aRegister->listOfPolynomials = NULL;
-                break;
-            }
-        }
-    } else if (toDelete.type == MATRIX) {
-        for (int i = 0; i < aRegister->sizes[MATRIX]; i++) {
-                if (!shorterString(aRegister->listOfMatrices[i].name, toDelete.any.matrix.name)) {
-                freeMatrix(&aRegister->listOfMatrices[i]);
-                for (int j = i; j < aRegister->sizes[MATRIX] - 1; j++) aRegister->listOfMatrices[j] = aRegister->listOfMatrices[j + 1];
-                if (--aRegister->sizes[MATRIX] == 0) aRegister->listOfMatrices = NULL;
-                break;
-            }
-        }
-    } else if (toDelete.type == VARIABLE) {
-        for (int i = 0; i < aRegister->sizes[VARIABLE]; i++) {
-            if (!shorterString(aRegister->listOfVariables[i].name, toDelete.any.variable.name)) {
-                freeVariable(&aRegister->listOfVariables[i]);
-                for (int j = i; j < aRegister->sizes[VARIABLE] - 1; j++) aRegister->listOfVariables[j] = aRegister->listOfVariables[j + 1];
-                if (--aRegister->sizes[VARIABLE] == 0) aRegister->listOfVariables = NULL;
-                break;
-            }
-        }
+    if (toDelete.type != POLYNOMIAL && toDelete.type != MATRIX && toDelete.type != VARIABLE) return;
+    RegisterEntry *entry = addEntry(aRegister, nameOf(toDelete));
+    entry->version = ++aRegister->version;
+    if (entry->object.type == toDelete.type) {
+        aRegister->sizes[(int) toDelete.type]--;
+        releaseObject(&entry->object);
     }
 }
 
 void addToRegister(Register *aRegister, Object toAdd) {
-    if (toAdd.type == POLYNOMIAL && toAdd.any.polynomial.name) {
-        Object found = searchObject(aRegister, toAdd.any.polynomial.name);
-        if (found.type == POLYNOMIAL) { //Overwriting current polynomial
-            for (int i = 0; i < aRegister->sizes[POLYNOMIAL]; i++) {
-                if (!shorterString(aRegister->listOfPolynomials[i].name, toAdd.any.polynomial.name)) {
-                    aRegister->listOfPolynomials[i] = toAdd.any.polynomial; break;
-                }
-            }
-            printf("Overwrote polynomial %s\n", toAdd.any.polynomial.name);
-        } else { //Adding new polynomial (and suppressing object with the same name if there is one)
-            if (found.type == MATRIX || found.type == VARIABLE) {
-                deleteFromRegister(aRegister, found);
-                printf("Overwrote object %s\n", toAdd.any.polynomial.name);
-            } else printf("New polynomial %s added\n", toAdd.any.polynomial.name);
-            aRegister->listOfPolynomials = realloc(aRegister->listOfPolynomials, ++aRegister->sizes[POLYNOMIAL] * sizeof(Polynomial));
-            aRegister->listOfPolynomials[aRegister->sizes[POLYNOMIAL] - 1] = toAdd.any.polynomial;
-        }
-    } else if (toAdd.type == MATRIX && toAdd.any.matrix.name) {
-        Object found = searchObject(aRegister, toAdd.any.matrix.name);
-        if (found.type == MATRIX) { //Overwriting current matrix
-            for (int i = 0; i < aRegister->sizes[MATRIX]; i++) {
-                if (!shorterString(aRegister->listOfMatrices[i].name, toAdd.any.matrix.name)) {
-                    aRegister->listOfMatrices[i] = toAdd.any.matrix; break;
-                }
-            }
-            printf("Overwrote matrix %s\n", toAdd.any.matrix.name);
-        } else { //Adding new matrix (and suppressing object with the same name if there is one)
-            if (found.type == POLYNOMIAL || found.type == VARIABLE) {
-                deleteFromRegister(aRegister, found);
-                printf("Overwrote object %s\n", toAdd.any.matrix.name);
-            } else printf("New matrix %s added\n", toAdd.any.matrix.name);
-            aRegister->listOfMatrices = realloc(aRegister->listOfMatrices, ++aRegister->sizes[MATRIX] * sizeof(Matrix));
-            aRegister->listOfMatrices[aRegister->sizes[MATRIX] - 1] = toAdd.any.matrix;
-        }
-    } else if (toAdd.type == VARIABLE && toAdd.any.variable.name) {
-        Object found = searchObject(aRegister, toAdd.any.variable.name);
-        if (found.type == VARIABLE) { //Overwriting current variable
-            for (int i = 0; i < aRegister->sizes[VARIABLE]; i++) {
-                if (!shorterString(aRegister->listOfVariables[i].name, toAdd.any.variable.name)) {
-                    aRegister->listOfVariables[i] = toAdd.any.variable; break;
-                }
-            }
-            printf("Overwrote variable %s\n", toAdd.any.variable.name);
-        } else { //Adding new variable (and suppressing object with the same name if there is one)
-            if (found.type == POLYNOMIAL || found.type == MATRIX) {
-                deleteFromRegister(aRegister, found);
-                printf("Overwrote object %s\n", toAdd.any.variable.name);
-            } else printf("New variable %s added\n", toAdd.any.variable.name);
-            aRegister->listOfVariables = realloc(aRegister->listOfVariables, ++aRegister->sizes[VARIABLE] * sizeof(Variable));
-            aRegister->listOfVariables[aRegister->sizes[VARIABLE] - 1] = toAdd.any.variable;
-        }
+    char *name = nameOf(toAdd);
+    if (!name) return;
+    RegisterEntry *entry = addEntry(aRegister, name);
+    entry->version = ++aRegister->version;
+    //The values are shared with the other names holding them, they are copied only before being modified. Temporaries
+    //of the command are moved on the heap first
+    if (toAdd.type == POLYNOMIAL) toAdd.any.polynomial = sharePolynomial(promotePolynomial(toAdd.any.polynomial));
+    else if (toAdd.type == MATRIX) toAdd.any.matrix = shareMatrix(promoteMatrix(toAdd.any.matrix));
+    if (entry->object.type == toAdd.type) { //Overwriting current object
+        writeStatus("Overwrote %s %s\n", typeNames[(int) toAdd.type], name);
+        releaseObject(&entry->object);
+    } else { //Adding new object (and suppressing object with the same name if there is one)
+        if (entry->object.type != UNUSED) {
+            deleteFromRegister(aRegister, entry->object);
+            writeStatus("Overwrote object %s\n", name);
+        } else writeStatus("New %s %s added\n", typeNames[(int) toAdd.type], name);
+        aRegister->sizes[(int) toAdd.type]++;
     }
+    entry->object = toAdd;
 }
 
 void printRegister(Register *aRegister) {
-    if (aRegister->listOfPolynomials) {
-        printf("===============Polynomials================\n");
-        for (int i = 0; i < aRegister->sizes[POLYNOMIAL]; i++) {
-            if (i != 0) printf("\n");
-            printPolynomial(aRegister->listOfPolynomials[i]);
-        }
-    }
-    if (aRegister->listOfMatrices) {
-        printf("=================Matrices=================\n");
-        for (int i = 0; i < aRegister->sizes[MATRIX]; i++) {
-            if (i != 0) printf("\n");
-            printMatrix(aRegister->listOfMatrices[i]);
-        }
-    }
-    if (aRegister->listOfVariables) {
-        printf("=================Variables=================\n");
-        for (int i = 0; i < aRegister->sizes[VARIABLE]; i++) {
-            if (i != 0) printf("\n");
-            printVariable(aRegister->listOfVariables[i]);
+    const char *titles[] = {"===============Polynomials================\n", "=================Matrices=================\n",
+                            "=================Variables=================\n"};
+    for (int type = POLYNOMIAL; type <= VARIABLE; type++) {
+        if (!aRegister->sizes[type]) continue;
+        writeText(titles[type]);
+        for (int i = 0, first = 1; i < aRegister->nbNames; i++) {
+            Object object = aRegister->entries[i].object;
+            if (object.type != type) continue;
+            if (!first) writeText("\n");
+            first = 0;
+            if (type == POLYNOMIAL) printPolynomial(object.any.polynomial);
+            else if (type == MATRIX) printMatrix(object.any.matrix);
+            else printVariable(object.any.variable);
         }
     }
-    if (!aRegister->listOfPolynomials && !aRegister->listOfMatrices && !aRegister->listOfVariables) printf("The register is empty\n");
-    else printf("==========================================\n");
+    if (!aRegister->sizes[POLYNOMIAL] && !aRegister->sizes[MATRIX] && !aRegister->sizes[VARIABLE]) writeText("The register is empty\n");
+    else writeText("==========================================\n");
 }
\ No newline at end of file
@@ -6,30 +6,21 @@
 #ifndef LINEARALGEBRA_REGISTER_H
 #define LINEARALGEBRA_REGISTER_H
 
-#include "matrix.h"
+#include "expression.h"
 
-#define newRegister {{0, 0, 0}, NULL, NULL, NULL} ///New empty register
+#define newRegister {{0, 0, 0}, 0, NULL, 0, NULL, 0} ///New empty register
 #define newObject (Object) {-1} ///New empty object
+#define REGISTER_CAPACITY 64 ///Initial number of places of the hash table of a register, it doubles when half of them are used
 
 #define UNUSED -1 ///Index used to initialise objects and say that no object were returned
 #define POLYNOMIAL 0 ///Index for polynomials
 #define MATRIX 1 ///Index for matrices
 #define VARIABLE 2 ///Index for variables
+#define EXPRESSION 3 ///Index for deferred matrix expressions, they are never stored in a register
 
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 // Structures
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-/**
- * @struct Register
- * Structure representing a container of objects used in this program
- */
-typedef struct {
-    int sizes[3]; ///Sizes of the list of objects
-    Polynomial *listOfPolynomials; ///List of polynomials
-    Matrix *listOfMatrices; ///List of matrices
-    Variable *listOfVariables; ///List of variables
-} Register;
-
 /**
  * @union Any
  * Structure that can contain any object
@@ -38,6 +29,7 @@ typedef union {
     Polynomial polynomial;
     Matrix matrix;
     Variable variable;
+    Expression *expression;
 } Any;
 
 /**
@@ -49,6 +41,30 @@ typedef struct {
     Any any; ///Object used
 } Object;
 
+/**
+ * @struct RegisterEntry
+ * Structure representing a name of a register, names are kept once their object is deleted to keep their version
+ */
+typedef struct {
+    char *name; ///The name, owned by the register
+    unsigned long long hash; ///Hash of the name
+    int version; ///Version of the register at the last assignment or deletion of the name
+    Object object; ///Object with this name, unused if it was deleted
+} RegisterEntry;
+
+/**
+ * @struct Register
+ * Structure representing a container of objects used in this program, the objects are found by the hash of their name
+ */
+typedef struct {
+    int sizes[3]; ///Number of objects of each type
+    int nbNames; ///Number of names that were ever assigned
+    RegisterEntry *entries; ///Names in the order of their first assignment
+    int capacity; ///Number of places of the hash table, a power of 2
+    int *places; ///Hash table of the indexes of the entries, found by linear probing, -1 for an empty place
+    int version; ///Number of modifications of the register
+} Register;
+
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 // Construction functions
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -72,7 +88,8 @@ Object checkObject(Object input);
 
 /**
  * Search for an object in a register
- * This function returns a corresponding object if it exist in the register and it's name matches. It returns NULL otherwise
+ * This function returns a corresponding object if it exist in the register and it's name matches. It returns an unused
+ * object otherwise, only the first word of the name is used
  * @param aRegister - The register to analyze
  * @param name - The name of the object to search
  * @return found object
@@ -96,6 +113,16 @@ void deleteFromRegister(Register *aRegister, Object toDelete);
  */
 void addToRegister(Register *aRegister, Object toAdd);
 
+/**
+ * Version of a name
+ * This function return the version of the register when a name was last assigned or deleted, results calculated from
+ * an object stay valid while the version of its name doesn't change
+ * @param aRegister - The register containing the name
+ * @param name - The name
+ * @return version of the name, 0 if it was never assigned
+ */
+int versionOf(Register *aRegister, const char *name);
+
 /**
  * Print the content of a register
  * This function prints the whole content of a register
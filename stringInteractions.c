@@ -6,18 +6,47 @@
  */
 
 #include "stringInteractions.h"
+#include "output.h"
 
-char *readString(FILE *current) {
-    int i = 0;
-    char temp, *string = NULL;
-    fscanf(current, " %c", &temp);
-    while (!feof(current) && temp >= ' ' && temp <= '~'){
-        string = realloc (string, (i + 2) * sizeof(char));
-        string[i] = temp;
-        fscanf(current, "%c", &temp);
-        i++;
-    } string[i] = '\0';
-    return string;
+LineReader newLineReader(FILE *stream) {
+    return (LineReader) {stream, malloc(LINE_READER_CAPACITY * sizeof(char)), LINE_READER_CAPACITY, 0, 0, 0};
+}
+
+void freeLineReader(LineReader *reader) {
+    free(reader->buffer);
+    *reader = (LineReader) {NULL, NULL, 0, 0, 0, 1};
+}
+
+char *cutCommand(char *buffer, int *start, int end, char last) {
+    //Separators and spaces before the command are skipped
+    int first = *start;
+    while (first < end && (buffer[first] <= ' ' || buffer[first] > '~')) first++;
+    int i = first;
+    while (i < end && buffer[i] >= ' ' && buffer[i] <= '~') i++;
+    if (first >= end || (i == end && !last)) {
+        *start = first;
+        return NULL;
+    }
+    buffer[i] = '\0';
+    *start = i + 1;
+    return buffer + first;
+}
+
+char *readLine(LineReader *reader) {
+    while (1) {
+        char *command = cutCommand(reader->buffer, &reader->start, reader->end, reader->ended);
+        if (command || reader->ended) return command;
+        //The beginning of the next command is moved at the beginning of the buffer, before reading the rest of its line
+        int kept = reader->end - reader->start;
+        if (reader->start > 0) for (int i = 0; i < kept; i++) reader->buffer[i] = reader->buffer[reader->start + i];
+        reader->start = 0; reader->end = kept;
+        if (2 * reader->end >= reader->capacity) {
+            reader->capacity *= 2;
+            reader->buffer = realloc(reader->buffer, reader->capacity * sizeof(char));
+        }
+        if (fgets(reader->buffer + reader->end, reader->capacity - reader->end, reader->stream)) reader->end += length(reader->buffer + reader->end);
+        else reader->ended = 1;
+    }
 }
 
 int length(const char *string) {
@@ -26,12 +55,21 @@ int length(const char *string) {
     return length;
 }
 
+unsigned long long hashContent(const char *content, int size) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (int i = 0; i < size; i++) {
+        hash ^= (unsigned char) content[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 char *firstWord(const char *string) {
     int firstLetterIndex = 0, k = 0;
     while (string[firstLetterIndex] == ' ') firstLetterIndex++;
-    char *word = NULL;
+    char *word = malloc(sizeof(char));
     for (int i = firstLetterIndex; string[i] && string[i] != ' ' && string[i] != '='; i++, k++) {
-        word = realloc(word, (i - firstLetterIndex + 1) * sizeof(char));
+        word = realloc(word, (i - firstLetterIndex + 2) * sizeof(char));
         word[k] = string[i];
     } word[k] = '\0';
     return word;
@@ -76,10 +114,11 @@ char *extractBetweenChar(const char *string, char first, char last) {
     while (string[firstIndex] && string[firstIndex] != first) firstIndex++;
     if (string[firstIndex]) {
         int j = 0; firstIndex++;
+        extracted = malloc(sizeof(char)); //Kept when nothing is between the chars
         for (int nbOfParenthesis = 0; string[firstIndex] && (string[firstIndex] != last || nbOfParenthesis > 0); firstIndex++) {
             if (string[firstIndex] == '(') nbOfParenthesis++;
             else if (string[firstIndex] == ')') nbOfParenthesis--;
-            extracted = realloc(extracted, ++j * sizeof(char));
+            extracted = realloc(extracted, (++j + 1) * sizeof(char));
             extracted[j - 1] = string[firstIndex];
         } extracted[j] = '\0';
     }
@@ -87,14 +126,21 @@ char *extractBetweenChar(const char *string, char first, char last) {
 }
 
 char *extractUpToIndex(const char *string, int last) {
-    char *extracted = NULL; int k = 0;
+    char *extracted = malloc(sizeof(char)); int k = 0;
     for (int j = 0; string[j] && j < last; j++) {
-        extracted = realloc(extracted, (j + 1) * sizeof(char));
+        extracted = realloc(extracted, (j + 2) * sizeof(char));
         extracted[k++] = string[j];
     } extracted[k] = '\0';
     return extracted;
 }
 
+char *temporaryString(const char *string, int last) {
+    char *extracted = temporaryMalloc((last + 1) * sizeof(char)); int k = 0;
+    for (int j = 0; string[j] && j < last; j++) extracted[k++] = string[j];
+    extracted[k] = '\0';
+    return extracted;
+}
+
 char *extractBetweenIndexes(const char *string, int first, int last) {
     if (string && length(string) >= last - first) {
         char *result = calloc(last - first + 2, sizeof(char));
@@ -104,6 +150,22 @@ char *extractBetweenIndexes(const char *string, int first, int last) {
     } else return NULL;
 }
 
+char **splitArguments(const char *string, int *nbArguments) {
+    char **arguments = NULL; *nbArguments = 0;
+    if (!string) return NULL;
+    for (int first = 0, i = 0, depth = 0;; i++) {
+        if (string[i] == '(' || string[i] == '[') depth++;
+        else if (string[i] == ')' || string[i] == ']') depth--;
+        else if (!string[i] || (string[i] == ',' && depth < 1)) {
+            arguments = realloc(arguments, ++*nbArguments * sizeof(char *));
+            arguments[*nbArguments - 1] = extractUpToIndex(string + first, i - first);
+            if (!string[i]) break;
+            first = i + 1;
+        }
+    }
+    return arguments;
+}
+
 char onlyContainValue(const char *string) {
     for (int i = 0; string[i]; i++) {
         if (string[i] != '+' && string[i] != '-' && string[i] != '.' && string[i] != ' ' &&
@@ -176,26 +238,60 @@ double readDoubleInString(const char *string, int *position) {
     int temp = 0;
     if (!position) position = &temp;
     //Search for the sign
-    while (*position >= 0 && string[*position] == ' ') (*position)--;
+    while (string[*position] == ' ') (*position)++;
     while (string[*position] && (string[*position] < '0' || string[*position] > '9') && string[*position] != '-') (*position)++;
     //Read the sign
     int sign = 1;
     if (string[*position] == '-') sign = -1;
     while (string[*position] == ' ' || string[*position] == '+' || string[*position] == '-') (*position)++;
     //Read the value
-    double result = 0;
-    do {
-        if (string[*position] >= '0' && string[*position] <= '9') result = result * 10 + string[(*position)++] - '0';
-        else if (string[(*position)++] == '.') {
-            double decimal = 0.1;
-            do {
-                result += (string[(*position)++] - '0') * decimal;
-                decimal /= 10;
-            } while (string[(*position)] >= '0' && string[(*position)] <= '9');
-        }
-    } while (string[*position] == '.' || (string[*position] >= '0' && string[*position] <= '9'));
+    int size;
+    double result = parseDouble(string + *position, &size);
+    *position += size;
     return result * sign;
 }
+
+double parseDouble(const char *string, int *length) {
+    //Powers of 10 that are exactly represented by a double
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    int i = 0, nbDigits = 0, nbSignificant = 0, exponent = 0;
+    char negative = 0, truncated = 0;
+    unsigned long long mantissa = 0;
+    if (string[i] == '-' || string[i] == '+') negative = string[i++] == '-';
+    //Digits are accumulated in an integer, the position of the point is kept in the exponent
+    for (char point = 0; (string[i] >= '0' && string[i] <= '9') || (string[i] == '.' && !point); i++) {
+        if (string[i] == '.') {
+            point = 1; continue;
+        }
+        nbDigits++;
+        if (nbSignificant < 19) {
+            mantissa = mantissa * 10 + string[i] - '0';
+            if (mantissa) nbSignificant++;
+            if (point) exponent--;
+        } else {
+            if (string[i] != '0') truncated = 1;
+            if (!point) exponent++;
+        }
+    }
+    if (!nbDigits) {
+        *length = 0;
+        return 0;
+    }
+    if (string[i] == 'e' || string[i] == 'E') { //The exponent is only read if it has digits
+        int j = i + 1, exponentSign = 1, value = 0;
+        if (string[j] == '-' || string[j] == '+') exponentSign = string[j++] == '-' ? -1 : 1;
+        if (string[j] >= '0' && string[j] <= '9') {
+            for (; string[j] >= '0' && string[j] <= '9'; j++) if (value < 100000) value = value * 10 + string[j] - '0';
+            exponent += exponentSign * value;
+            i = j;
+        }
+    }
+    *length = i;
+    if (truncated || mantissa > (1ULL << 53) || exponent < -22 || exponent > 22) return strtod(string, NULL);
+    double result = exponent < 0 ? (double) mantissa / powers[-exponent] : (double) mantissa * powers[exponent];
+    return negative ? -result : result;
+}
 #pragma clang diagnostic pop
 
 void printFileContent(const char *link, FILE *output) {
@@ -203,7 +299,7 @@ void printFileContent(const char *link, FILE *output) {
     if (input) {
         while (!feof(input)) fprintf(output, "%c", getc(input));
         fclose(input);
-    } else fprintf(stderr, "File was not found at %s", link);
+    } else writeError("File was not found at %s", link);
 }
 
 StringMatrix newStringMatrix(int nbRows, int nbColumns) {
@@ -237,7 +333,11 @@ StringMatrix removeSColumn(StringMatrix M, int columnIndex) {
 
 StringMatrix changeToPLambdaForm(StringMatrix M) {
     for (int i = 0; i < M.rows; i++) {
-        snprintf(M.values[i][i], (length(M.values[i][i]) + 6) * sizeof(char), "%s - 1X", M.values[i][i]);
+        int size = length(M.values[i][i]) + 6;
+        char *withVariable = malloc(size * sizeof(char));
+        snprintf(withVariable, size * sizeof(char), "%s - 1X", M.values[i][i]);
+        free(M.values[i][i]);
+        M.values[i][i] = withVariable;
     }
     return M;
 }
@@ -248,29 +348,14 @@ char *detOfStringMatrix(StringMatrix M) {
         char *result = NULL;
         for (int i = 0, sign = 1; i < M.rows; i++, sign *= -1) {
             char *detOfSubDet = detOfStringMatrix(removeSRow(removeSColumn(M, 0), i));
-            int totalSize = length(M.values[i][0]) + length(detOfSubDet);
-            
-            if (!result) {
-                if (sign == 1) {
-                    totalSize += 8;
-                    result = realloc(result, totalSize * sizeof(char));
-                    snprintf(result, totalSize * sizeof(char), "(%s) * (%s)", M.values[i][0], detOfSubDet);
-                } else {
-                    totalSize += 14;
-                    result = realloc(result, totalSize * sizeof(char));
-                    snprintf(result, totalSize * sizeof(char), "(%s) * (-1) * (%s)", M.values[i][0], detOfSubDet);
-                }
-            } else {
-                if (sign == 1) {
-                    totalSize += 14 + length(result);
-                    result = realloc(result, totalSize * sizeof(char));
-                    snprintf(result, totalSize * sizeof(char), "%s + (%s) * (%s)", result, M.values[i][0], detOfSubDet);
-                } else {
-                    totalSize += 21 + length(result);
-                    result = realloc(result, totalSize * sizeof(char));
-                    snprintf(result, totalSize * sizeof(char), "%s + (%s) * (-1) * (%s)", result, M.values[i][0], detOfSubDet);
-                }
-            }
+            //The previous result is copied in a new string, a string can't be written into itself
+            const char *format = sign == 1 ? "%s%s(%s) * (%s)" : "%s%s(%s) * (-1) * (%s)";
+            const char *previous = result ? result : "", *separator = result ? " + " : "";
+            int totalSize = snprintf(NULL, 0, format, previous, separator, M.values[i][0], detOfSubDet) + 1;
+            char *extended = malloc(totalSize * sizeof(char));
+            snprintf(extended, totalSize * sizeof(char), format, previous, separator, M.values[i][0], detOfSubDet);
+            free(result);
+            result = extended;
         }
         return result;
     }
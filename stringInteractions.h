@@ -6,20 +6,63 @@
 #ifndef LINEARALGEBRA_STRINGINTERACTIONS_H
 #define LINEARALGEBRA_STRINGINTERACTIONS_H
 
-#include <stdlib.h>
+#include "arena.h"
 #include <stdio.h>
 
+#define LINE_READER_CAPACITY 4096 ///Initial size of the buffer of a line reader
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct LineReader
+ * Structure representing a buffered reading of commands in a file stream, the commands are given as slices of its buffer
+ */
+typedef struct {
+    FILE *stream; ///The file stream read
+    char *buffer; ///Characters read from the stream
+    int capacity; ///Size of the buffer, it doubles when the unread characters fill half of it
+    int start; ///Index of the first character not given yet
+    int end; ///Number of characters in the buffer
+    char ended; ///1 when the end of the stream was reached
+} LineReader;
+
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 // Construction functions
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Create a line reader
+ * @param stream - The file stream to read
+ * @return created line reader
+ */
+LineReader newLineReader(FILE *stream);
+
+/**
+ * Free a line reader
+ * @param reader - The line reader to free, the stream isn't closed
+ */
+void freeLineReader(LineReader *reader);
 
 /**
- * Read a string in a file stream
- * This function read a string of any size in a given file stream. It will get all visible characters in the ASCII table
- * @param current - The file stream where the string will be read
- * @return string formed from the file stream
+ * Cut the next command of a buffer
+ * Commands are made of the visible characters of the ASCII table and spaces, they are separated by any other character.
+ * The character ending the command is replaced by \0 so that the command can be used without being copied
+ * @param buffer - The buffer containing the commands
+ * @param start - Index of the first character to read, moved after the command
+ * @param end - Number of characters of the buffer, buffer[end] must exist
+ * @param last - 1 if the buffer is complete, its last command doesn't need to be followed by a separator
+ * @return the command in the buffer, NULL if there is no whole command
  */
-char *readString(FILE *current);
+char *cutCommand(char *buffer, int *start, int end, char last);
+
+/**
+ * Read a command in a file stream
+ * This function read the stream by blocks of lines in the buffer of the reader, only when it doesn't contain a whole
+ * command anymore
+ * @param reader - The line reader
+ * @return the command, in the buffer of the reader until the next reading, NULL at the end of the stream
+ */
+char *readLine(LineReader *reader);
 
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 // Basic operator functions
@@ -34,6 +77,15 @@ char *readString(FILE *current);
  */
 int length(const char *string);
 
+/**
+ * Hash a content
+ * This function calculate the 64 bits FNV-1a hash of a content
+ * @param content - The content to hash
+ * @param size - Number of bytes of the content
+ * @return hash of the content
+ */
+unsigned long long hashContent(const char *content, int size);
+
 /**
  * First word of a string
  * This function return the first word of a string (surrounded by whitespaces)
@@ -75,7 +127,7 @@ char containCharInOrder(const char *string, const char *charToSearch);
  * @param string - The original string
  * @param first - The first character
  * @param last - The second character
- * @return extracted string
+ * @return extracted string, empty if nothing is between them, NULL if the first character is missing
  */
 char *extractBetweenChar(const char *string, char first, char last);
 
@@ -98,6 +150,24 @@ char *extractBetweenIndexes(const char *string, int first, int last);
  */
 char *extractUpToIndex(const char *string, int last);
 
+/**
+ * Extract up to an index in a temporary string
+ * This function return the string until an index, allocated in the arena of the command
+ * @param string - The original string
+ * @param last - The end index
+ * @return extracted string
+ */
+char *temporaryString(const char *string, int last);
+
+/**
+ * Split arguments
+ * This function split a string on the commas that are outside of parenthesis and brackets
+ * @param string - The string containing the arguments
+ * @param nbArguments - Where the number of arguments found is written
+ * @return array of the arguments in string format
+ */
+char **splitArguments(const char *string, int *nbArguments);
+
 /**
  * Check if there exist an operator outside of parenthesis
  * @param string - String to scan
@@ -146,6 +216,17 @@ char everythingIsBetweenParenthesis(const char *string);
  */
 double readDoubleInString(const char *string, int *position);
 
+/**
+ * Parse a number
+ * This function parse a decimal number "[sign]digits[.digits][e[sign]digits]" correctly rounded. Numbers with at most
+ * 19 significant digits and a small power of 10 are calculated exactly with a single multiplication or division,
+ * the others are given to strtod
+ * @param string - The string starting with the number
+ * @param length - Return the number of characters of the number, 0 if the string doesn't start with a number
+ * @return parsed number
+ */
+double parseDouble(const char *string, int *length);
+
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 // File interactions
 //-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
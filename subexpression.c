@@ -0,0 +1,171 @@
+/**
+ * @file subexpression.c Functions on calculated subexpressions
+ * @author Valentin Koeltgen
+ *
+ * This file contain the table of calculated subexpressions, it is used to calculate identical function calls only once,
+ * in the same command or in following ones while the objects they use aren't changed
+ */
+
+#include "main.h"
+
+///Table of calculated subexpressions, an entry is chosen by the hash of its key
+Subexpression subexpressions[SUBEXPRESSION_CAPACITY];
+
+/**
+ * Concatenate strings
+ * @param strings - Strings to concatenate
+ * @param nbStrings - Number of strings
+ * @return concatenated string
+ */
+char *concatenate(const char **strings, int nbStrings) {
+    int size = 0;
+    for (int i = 0; i < nbStrings; i++) size += length(strings[i]);
+    char *result = malloc((size + 1) * sizeof(char));
+    size = 0;
+    for (int i = 0; i < nbStrings; i++) for (int j = 0; strings[i][j]; j++) result[size++] = strings[i][j];
+    result[size] = '\0';
+    return result;
+}
+
+char *subexpressionKey(Node *node) {
+    char buffer[64];
+    if (node->type == NODE_NUMBER) {
+        snprintf(buffer, sizeof(buffer), "%.17g", node->value);
+        return extractUpToIndex(buffer, length(buffer));
+    } else if (node->type == NODE_TERM) {
+        snprintf(buffer, sizeof(buffer), "%.17gX^%d", node->value, node->power);
+        return extractUpToIndex(buffer, length(buffer));
+    } else if (node->type == NODE_NAME) {
+        char delimiter[2] = {KEY_NAME_DELIMITER, '\0'};
+        return concatenate((const char *[]) {delimiter, node->name, delimiter}, 3);
+    }
+    if (node->type == NODE_MATRIX && node->matrix.values) { //Written like a literal of number cells
+        char *key = extractUpToIndex("[", 1);
+        int size = 1;
+        for (int i = 0; i < node->rows; i++) {
+            for (int j = 0; j < node->columns; j++) {
+                int written = snprintf(buffer, sizeof(buffer), "%.17g%c", node->matrix.values[i][j],
+                                       j < node->columns - 1 ? ',' : i < node->rows - 1 ? ';' : ']');
+                key = realloc(key, size + written + 1);
+                for (int k = 0; k <= written; k++) key[size + k] = buffer[k];
+                size += written;
+            }
+        }
+        return key;
+    }
+    //Keys of the children, then the node around them
+    char **keys = malloc((node->nbChildren ? node->nbChildren : 1) * sizeof(char *));
+    for (int i = 0; i < node->nbChildren; i++) keys[i] = subexpressionKey(node->children[i]);
+    if (node->type == NODE_OPERATION && node->operator == '+' && shorterString(keys[0], keys[1]) == 2) {
+        char *swap = keys[0]; keys[0] = keys[1]; keys[1] = swap;
+    }
+    //Every child is preceded by a separator: the opening character, the operator, a comma or a semicolon
+    int nbParts = node->nbChildren ? 2 * node->nbChildren + 2 : 3;
+    const char **parts = malloc(nbParts * sizeof(char *));
+    char operator[2] = {node->operator, '\0'};
+    parts[0] = node->type == NODE_CALL ? functionNames[node->function] : node->type == NODE_NEGATE ? "-" : "";
+    parts[1] = node->type == NODE_MATRIX ? "[" : "(";
+    for (int i = 0; i < node->nbChildren; i++) {
+        if (i > 0) {
+            if (node->type == NODE_OPERATION) parts[2 * i + 1] = operator;
+            else if (node->type == NODE_MATRIX && i % node->columns == 0) parts[2 * i + 1] = ";";
+            else parts[2 * i + 1] = ",";
+        }
+        parts[2 * i + 2] = keys[i];
+    }
+    parts[nbParts - 1] = node->type == NODE_MATRIX ? "]" : ")";
+    char *key = concatenate(parts, nbParts);
+    for (int i = 0; i < node->nbChildren; i++) free(keys[i]);
+    free(keys); free(parts);
+    return key;
+}
+
+/**
+ * Verify if a syntax tree loads or imports a file
+ * @param node - Root of the tree
+ * @return result of the check
+ */
+char isLoading(Node *node) {
+    if (node->type == NODE_CALL && (node->function == FUNCTION_LOAD || node->function == FUNCTION_IMPORT)) return 1;
+    for (int i = 0; i < node->nbChildren; i++) if (isLoading(node->children[i])) return 1;
+    return 0;
+}
+
+char isRememberedCall(Node *node) {
+    return node->function >= NB_FINAL_FUNCTIONS && node->function != FUNCTION_TRANSPOSE && !isLoading(node);
+}
+
+/**
+ * Share an object with the table
+ * @param object - The object to share, a temporary of the command is moved on the heap
+ * @return the object with a new holder, without its name
+ */
+Object shareObject(Object object) {
+    if (object.type == POLYNOMIAL) {
+        Polynomial F = sharePolynomial(promotePolynomial(object.any.polynomial));
+        F.name = NULL;
+        return (Object) {POLYNOMIAL, .any.polynomial = F};
+    } else if (object.type == MATRIX) {
+        Matrix M = shareMatrix(promoteMatrix(object.any.matrix));
+        M.name = NULL;
+        return (Object) {MATRIX, .any.matrix = M};
+    } else if (object.type == VARIABLE) return (Object) {VARIABLE, .any.variable = newVariable(object.any.variable.value)};
+    else return newObject;
+}
+
+/**
+ * Empty an entry of the table
+ * @param entry - The entry to empty
+ */
+void clearSubexpression(Subexpression *entry) {
+    for (int i = 0; i < entry->nbNames; i++) free(entry->names[i]);
+    free(entry->names); free(entry->versions);
+    if (entry->key && entry->value.type == POLYNOMIAL) freePolynomial(&entry->value.any.polynomial);
+    else if (entry->key && entry->value.type == MATRIX) freeMatrix(&entry->value.any.matrix);
+    free(entry->key);
+    *entry = (Subexpression) {NULL, 0, 0, NULL, NULL, newObject, 0};
+}
+
+Object findSubexpression(Register *aRegister, const char *key) {
+    unsigned long long hash = hashContent(key, length(key));
+    Subexpression *entry = &subexpressions[hash & (SUBEXPRESSION_CAPACITY - 1)];
+    if (!entry->key || entry->hash != hash || shorterString(entry->key, key)) return newObject;
+    for (int i = 0; i < entry->nbNames; i++) {
+        if (versionOf(aRegister, entry->names[i]) != entry->versions[i]) { //An object changed, the result is outdated
+            if (!entry->found) clearSubexpression(entry);
+            return newObject;
+        }
+    }
+    //The values are shared like the ones of the register, the caller copies them before modifying them
+    entry->found = 1;
+    return entry->value;
+}
+
+Object rememberSubexpression(Register *aRegister, const char *key, Object value) {
+    if (value.type != POLYNOMIAL && value.type != MATRIX && value.type != VARIABLE) return value;
+    unsigned long long hash = hashContent(key, length(key));
+    Subexpression *entry = &subexpressions[hash & (SUBEXPRESSION_CAPACITY - 1)];
+    if (entry->found) return value; //The command may still use the result of the entry
+    clearSubexpression(entry);
+    pauseArena(); //The entry outlives the command
+    *entry = (Subexpression) {extractUpToIndex(key, length(key)), hash, 0, NULL, NULL, shareObject(value), 0};
+    resumeArena();
+    //Names are between delimiters, their versions are kept to know when the result becomes outdated
+    for (int i = 0; key[i]; i++) {
+        if (key[i] == KEY_NAME_DELIMITER) {
+            int end = i + 1;
+            while (key[end] != KEY_NAME_DELIMITER) end++;
+            entry->names = realloc(entry->names, (entry->nbNames + 1) * sizeof(char *));
+            entry->versions = realloc(entry->versions, (entry->nbNames + 1) * sizeof(int));
+            entry->names[entry->nbNames] = extractUpToIndex(key + i + 1, end - i - 1);
+            entry->versions[entry->nbNames] = versionOf(aRegister, entry->names[entry->nbNames]);
+            entry->nbNames++;
+            i = end;
+        }
+    }
+    return entry->value;
+}
+
+void releaseSubexpressions() {
+    for (int i = 0; i < SUBEXPRESSION_CAPACITY; i++) subexpressions[i].found = 0;
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+/**
+ * @file subexpression.h Header file of subexpression.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_SUBEXPRESSION_H
+#define LINEARALGEBRA_SUBEXPRESSION_H
+
+#include "parser.h"
+
+#define SUBEXPRESSION_CAPACITY 256 ///Number of entries of the table of calculated subexpressions, must be a power of 2
+#define KEY_NAME_DELIMITER '\1' ///Character around the names in a key, it can't be part of a name
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct Subexpression
+ * Structure representing a calculated subexpression, it stays valid while the names it uses keep their version
+ */
+typedef struct {
+    char *key; ///Normalized form of the subexpression, NULL for an empty entry
+    unsigned long long hash; ///Hash of the key
+    int nbNames; ///Number of names used by the subexpression
+    char **names; ///Names used by the subexpression
+    int *versions; ///Versions of the names when the subexpression was calculated
+    Object value; ///Result of the subexpression, the entry is one of its holders
+    char found; ///1 if the result was given during the current command, the entry is then kept until the command ends
+} Subexpression;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Key of a subexpression
+ * This function write a syntax tree in a normalized form: numbers are written with all their digits, names are
+ * delimited and the operands of a sum are sorted, so that identical subexpressions have the same key
+ * @param node - Root of the subexpression
+ * @return key of the subexpression
+ */
+char *subexpressionKey(Node *node);
+
+/**
+ * Verify if a function call can be remembered
+ * Transpositions are deferred and cost nothing to rebuild, they aren't remembered. Calls using a loaded or imported file
+ * aren't remembered either, the file can change between them
+ * @param node - The call
+ * @return result of the check
+ */
+char isRememberedCall(Node *node);
+
+/**
+ * Search for a calculated subexpression
+ * @param aRegister - The register containing the names used by the subexpression
+ * @param key - Key of the subexpression
+ * @return calculated result, shared with the table like the objects of the register, an unused object if it wasn't
+ * calculated or a name it uses changed since
+ */
+Object findSubexpression(Register *aRegister, const char *key);
+
+/**
+ * Remember a calculated subexpression
+ * The result is shared with the table instead of copied, a temporary of the command is moved on the heap first
+ * @param aRegister - The register containing the names used by the subexpression
+ * @param key - Key of the subexpression
+ * @param value - Result of the subexpression
+ * @return the result to use instead of value, its values are copied before being modified
+ */
+Object rememberSubexpression(Register *aRegister, const char *key, Object value);
+
+/**
+ * End a command using the calculated subexpressions
+ * The results found during the command can be replaced again
+ */
+void releaseSubexpressions();
+
+#endif //LINEARALGEBRA_SUBEXPRESSION_H
\ No newline at end of file
@@ -0,0 +1,125 @@
+/**
+ * @file tracer.c Functions on the tracer
+ * @author Valentin Koeltgen
+ *
+ * This file contain the recording of the events of the program: the lines of the scripts, the parse and the evaluation
+ * of the commands, the kernels and the lines imported by each thread. They are written in the Chrome trace event format
+ * once the trace is stopped
+ */
+
+#include "tracer.h"
+#include "profiler.h"
+#include "stringInteractions.h"
+#include "output.h"
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+char tracing = 0;
+TraceEvent *traceEvents = NULL; ///Recorded events, in the order of their timestamps for each thread
+int nbTraceEvents = 0; ///Number of recorded events
+int traceCapacity = 0; ///Size of traceEvents
+int droppedTraceEvents = 0; ///Number of events begun once the trace was full
+double traceStart = 0; ///Wall time of the start of the trace in seconds
+int traceMainThread = 0; ///Thread which started the trace
+FILE *traceOutput = NULL; ///Trace file, opened when the trace starts
+char *traceLink = NULL; ///Link of the trace file
+pthread_mutex_t traceLock = PTHREAD_MUTEX_INITIALIZER; ///Lock of the events, the import threads record theirs too
+__thread int traceThread = 0; ///Identifier of the current thread, 0 until its first event
+int nbTraceThreads = 0; ///Number of identified threads, on the systems without thread identifiers
+
+/**
+ * Identifier of the current thread
+ * @return identifier of the thread given by the system, or its order of arrival in the trace
+ */
+int currentTraceThread() {
+    if (!traceThread) {
+#ifdef __linux__
+        traceThread = (int) syscall(SYS_gettid);
+#else
+        traceThread = __atomic_add_fetch(&nbTraceThreads, 1, __ATOMIC_RELAXED);
+#endif
+    }
+    return traceThread;
+}
+
+/**
+ * Record an event
+ * @param event - The event, its thread and timestamp are set by this function
+ * @param begin - 1 for the begin of an event, it is dropped when the trace is full
+ * @return 1 if the event was recorded, 0 otherwise
+ */
+char recordTraceEvent(TraceEvent event, char begin) {
+    event.thread = currentTraceThread();
+    pthread_mutex_lock(&traceLock);
+    event.timestamp = (wallTime() - traceStart) * 1e6;
+    //The ends are always kept, so that the events stay nested, the ends of the events of a stopped trace are ignored
+    char recorded = tracing && (!begin || nbTraceEvents < TRACE_MAX_EVENTS);
+    if (recorded && nbTraceEvents == traceCapacity) {
+        traceCapacity *= 2;
+        traceEvents = realloc(traceEvents, traceCapacity * sizeof(TraceEvent));
+    }
+    if (recorded) traceEvents[nbTraceEvents++] = event;
+    else if (tracing) droppedTraceEvents++;
+    pthread_mutex_unlock(&traceLock);
+    return recorded;
+}
+
+char beginTraceEvent(const char *category, const char *name, int number) {
+    return recordTraceEvent((TraceEvent) {category, name, number, 0, 0}, 1);
+}
+
+void endTraceEvent() {
+    recordTraceEvent((TraceEvent) {NULL, NULL, -1, 0, 0}, 0);
+}
+
+char startTrace(const char *link) {
+    traceOutput = fopen(link, "w");
+    if (!traceOutput) return 0;
+    traceLink = malloc((length(link) + 1) * sizeof(char));
+    for (int i = 0; i <= length(link); i++) traceLink[i] = link[i];
+    traceCapacity = TRACE_CAPACITY;
+    traceEvents = malloc(traceCapacity * sizeof(TraceEvent));
+    nbTraceEvents = 0;
+    droppedTraceEvents = 0;
+    traceMainThread = currentTraceThread();
+    traceStart = wallTime();
+    tracing = 1;
+    return 1;
+}
+
+int stopTrace() {
+    if (!tracing) return -1;
+    tracing = 0;
+    int process = (int) getpid();
+    fprintf(traceOutput, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    fprintf(traceOutput, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": \"main\"}}",
+            process, traceMainThread);
+    for (int i = 0; i < nbTraceEvents; i++) {
+        TraceEvent event = traceEvents[i];
+        if (!event.category) {
+            fprintf(traceOutput, ",\n{\"ph\": \"E\", \"ts\": %.3f, \"pid\": %d, \"tid\": %d}", event.timestamp, process, event.thread);
+        } else {
+            fprintf(traceOutput, ",\n{\"name\": \"%s", event.name);
+            if (event.number >= 0) fprintf(traceOutput, " %d", event.number);
+            fprintf(traceOutput, "\", \"cat\": \"%s\", \"ph\": \"B\", \"ts\": %.3f, \"pid\": %d, \"tid\": %d}", event.category,
+                    event.timestamp, process, event.thread);
+        }
+    }
+    fprintf(traceOutput, "\n]}\n");
+    fclose(traceOutput);
+    writeFormat("%d events were written in %s", nbTraceEvents, traceLink);
+    if (droppedTraceEvents) writeFormat(", %d were dropped once the trace was full", droppedTraceEvents);
+    writeText("\n");
+    int nbEvents = nbTraceEvents;
+    free(traceEvents);
+    free(traceLink);
+    traceEvents = NULL;
+    traceOutput = NULL;
+    traceLink = NULL;
+    nbTraceEvents = 0;
+    return nbEvents;
+}
\ No newline at end of file
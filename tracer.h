@@ -0,0 +1,66 @@
+/**
+ * @file tracer.h Header file of tracer.c
+ * @author Valentin Koeltgen
+ */
+
+#ifndef LINEARALGEBRA_TRACER_H
+#define LINEARALGEBRA_TRACER_H
+
+#define TRACE_CAPACITY 4096 ///Initial number of events of the trace
+#define TRACE_MAX_EVENTS (1 << 22) ///Most events of a trace, the next ones are dropped
+
+extern char tracing; ///1 while the events are recorded
+
+///Begin an event of the current thread, a single test when nothing is traced, 1 if the event was recorded
+#define traceBegin(category, name, number) (tracing && beginTraceEvent(category, name, number))
+///End the last event begun by the current thread, only if it was recorded
+#define traceEnd(traced) if (traced) endTraceEvent()
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct TraceEvent
+ * Structure representing the begin or the end of an event
+ */
+typedef struct {
+    const char *category; ///Category of the event (script, phase, kernel or import), NULL for an end
+    const char *name; ///Name of the event, it must live until the trace is written
+    int number; ///Number written after the name, -1 for none
+    int thread; ///Identifier of the thread of the event
+    double timestamp; ///Microseconds since the start of the trace
+} TraceEvent;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Begin an event, use traceBegin instead
+ * @param category - Category of the event
+ * @param name - Name of the event
+ * @param number - Number written after the name, -1 for none
+ * @return 1 if the event was recorded, 0 if the trace is full
+ */
+char beginTraceEvent(const char *category, const char *name, int number);
+
+/**
+ * End the last event begun by the current thread, use traceEnd instead
+ */
+void endTraceEvent();
+
+/**
+ * Start recording the events
+ * The trace is written in the file when it is stopped
+ * @param link - Link of the trace file
+ * @return 1 if the file can be written, 0 otherwise
+ */
+char startTrace(const char *link);
+
+/**
+ * Stop recording the events and write them
+ * The events are written in the Chrome trace event format, which can be opened in Perfetto or chrome://tracing
+ * @return number of written events, -1 if nothing was traced
+ */
+int stopTrace();
+
+#endif //LINEARALGEBRA_TRACER_H
\ No newline at end of file
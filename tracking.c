@@ -0,0 +1,239 @@
+/**
+ * @file tracking.c Functions on the allocation tracking
+ * @author Valentin Koeltgen
+ *
+ * This file contain the counting of the allocations by call site and by top-level command. It is only done when the
+ * program is built with TRACK_ALLOCATIONS, the arena is then disabled so that the temporaries a command drops stay live
+ */
+
+#define ALLOCATION_IMPLEMENTATION
+#include "tracking.h"
+#include "output.h"
+#include "stringInteractions.h"
+
+#ifdef TRACK_ALLOCATIONS
+
+#include <pthread.h>
+#include <stdint.h>
+
+AllocationCount trackedSites[TRACKING_MAX_SITES]; ///Call sites, by hash of their file and line
+AllocationCount trackedCommands[TRACKING_MAX_COMMANDS]; ///Top-level commands, by hash of their text
+int nbTrackedCommands = 0; ///Number of commands counted apart
+AllocationCount startupCommand = {"(start)", 0, 0, 0, 0}; ///Allocations before the first command
+AllocationCount otherCommands = {"(other commands)", 0, 0, 0, 0}; ///Commands past TRACKING_MAX_COMMANDS
+AllocationCount *currentCommand = &startupCommand; ///Command being executed
+AllocationCount totalAllocations = {"(total)", 0, 0, 0, 0}; ///Allocations of the whole program
+long long peakBytes = 0; ///Most live bytes since the last reset
+TrackedBlock *trackedBlocks = NULL; ///Allocated blocks, by hash of their address
+size_t nbTrackedBlocks = 0, nbTrackedPlaces = 0, trackedCapacity = 0; ///Live blocks, used places (with removed ones), size
+const char removedBlock = 0; ///Address marking a place whose block was freed
+pthread_mutex_t trackingLock = PTHREAD_MUTEX_INITIALIZER; ///Lock of the counts, the import threads allocate too
+
+/**
+ * Mix the bits of a value
+ * @param value - The value
+ * @return hash of the value
+ */
+unsigned long long mixBits(unsigned long long value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    return value ^ (value >> 33);
+}
+
+/**
+ * Count of a call site
+ * @param file - File of the call site
+ * @param line - Line of the call site
+ * @return count of the call site, created if it wasn't counted yet
+ */
+AllocationCount *siteOf(const char *file, int line) {
+    size_t place = mixBits((uintptr_t) file * 31 + (unsigned) line) & (TRACKING_MAX_SITES - 1);
+    while (trackedSites[place].file && (trackedSites[place].file != file || trackedSites[place].line != line)) {
+        place = (place + 1) & (TRACKING_MAX_SITES - 1);
+    }
+    if (!trackedSites[place].file) trackedSites[place] = (AllocationCount) {file, line, 0, 0, 0};
+    return &trackedSites[place];
+}
+
+/**
+ * Count of a top-level command
+ * Commands are named by their first characters
+ * @param command - The command
+ * @return count of the command, created if it wasn't counted yet
+ */
+AllocationCount *commandOf(const char *command) {
+    int size = 0;
+    while (command[size] && size < TRACKING_COMMAND_SIZE) size++;
+    size_t place = hashContent(command, size) & (TRACKING_MAX_COMMANDS - 1);
+    while (trackedCommands[place].file) {
+        int i = 0;
+        while (i < size && trackedCommands[place].file[i] == command[i]) i++;
+        if (i == size && !trackedCommands[place].file[i]) return &trackedCommands[place];
+        place = (place + 1) & (TRACKING_MAX_COMMANDS - 1);
+    }
+    if (2 * (nbTrackedCommands + 1) > TRACKING_MAX_COMMANDS) return &otherCommands;
+    char *name = malloc(size + 1);
+    for (int i = 0; i < size; i++) name[i] = command[i];
+    name[size] = '\0';
+    nbTrackedCommands++;
+    trackedCommands[place] = (AllocationCount) {name, 0, 0, 0, 0};
+    return &trackedCommands[place];
+}
+
+/**
+ * Place of a block in the table of the blocks
+ * @param block - The block
+ * @return place of the block, or of the empty entry where it can be added
+ */
+size_t placeOf(const void *block) {
+    size_t place = mixBits((uintptr_t) block) & (trackedCapacity - 1);
+    while (trackedBlocks[place].block && trackedBlocks[place].block != block) place = (place + 1) & (trackedCapacity - 1);
+    return place;
+}
+
+/**
+ * Count an allocated block
+ * @param block - The block
+ * @param size - Number of bytes
+ * @param site - Call site of the allocation
+ */
+void addBlock(const void *block, size_t size, AllocationCount *site) {
+    if ((nbTrackedPlaces + 1) * 2 > trackedCapacity) { //The table is rebuilt without the removed blocks
+        TrackedBlock *blocks = trackedBlocks;
+        size_t capacity = trackedCapacity;
+        while ((nbTrackedBlocks + 1) * 4 > trackedCapacity) trackedCapacity = trackedCapacity ? 2 * trackedCapacity : 1024;
+        trackedBlocks = calloc(trackedCapacity, sizeof(TrackedBlock));
+        for (size_t i = 0; i < capacity; i++) {
+            if (blocks[i].block && blocks[i].block != &removedBlock) trackedBlocks[placeOf(blocks[i].block)] = blocks[i];
+        }
+        nbTrackedPlaces = nbTrackedBlocks;
+        free(blocks);
+    }
+    trackedBlocks[placeOf(block)] = (TrackedBlock) {block, size, site, currentCommand};
+    nbTrackedBlocks++; nbTrackedPlaces++;
+    AllocationCount *counts[] = {site, currentCommand, &totalAllocations};
+    for (int i = 0; i < 3; i++) {
+        counts[i]->count++;
+        counts[i]->bytes += (long long) size;
+        counts[i]->liveBytes += (long long) size;
+    }
+    if (totalAllocations.liveBytes > peakBytes) peakBytes = totalAllocations.liveBytes;
+}
+
+/**
+ * Stop counting a freed block
+ * @param block - The block, blocks allocated by the C library itself aren't counted
+ */
+void removeBlock(const void *block) {
+    if (!block || !trackedCapacity) return;
+    TrackedBlock *entry = &trackedBlocks[placeOf(block)];
+    if (!entry->block) return;
+    entry->site->liveBytes -= (long long) entry->size;
+    entry->command->liveBytes -= (long long) entry->size;
+    totalAllocations.liveBytes -= (long long) entry->size;
+    entry->block = &removedBlock;
+    nbTrackedBlocks--;
+}
+
+void *trackedAllocate(int allocator, int operation, void *block, size_t number, size_t size, const char *file, int line) {
+    if (operation == TRACKED_REALLOC) {
+        pthread_mutex_lock(&trackingLock);
+        removeBlock(block);
+        pthread_mutex_unlock(&trackingLock);
+    }
+    void *allocated;
+    if (allocator == TRACKED_HEAP) {
+        allocated = operation == TRACKED_MALLOC ? malloc(size) : operation == TRACKED_CALLOC ? calloc(number, size) : realloc(block, size);
+    } else if (allocator == TRACKED_POOL) {
+        allocated = operation == TRACKED_MALLOC ? poolMalloc(size) : operation == TRACKED_CALLOC ? poolCalloc(number, size) : poolRealloc(block, size);
+    } else {
+        allocated = operation == TRACKED_MALLOC ? temporaryMalloc(size) : operation == TRACKED_CALLOC ? temporaryCalloc(number, size) : temporaryRealloc(block, size);
+    }
+    if (allocated) {
+        pthread_mutex_lock(&trackingLock);
+        addBlock(allocated, number * size, siteOf(file, line));
+        pthread_mutex_unlock(&trackingLock);
+    }
+    return allocated;
+}
+
+void trackedFree(int allocator, void *block) {
+    pthread_mutex_lock(&trackingLock);
+    removeBlock(block);
+    pthread_mutex_unlock(&trackingLock);
+    if (allocator == TRACKED_HEAP) free(block);
+    else if (allocator == TRACKED_POOL) poolFree(block);
+    else temporaryFree(block);
+}
+
+void trackCommand(const char *command) {
+    pthread_mutex_lock(&trackingLock);
+    currentCommand = commandOf(command);
+    pthread_mutex_unlock(&trackingLock);
+}
+
+/**
+ * Display the counts allocating the most bytes
+ * @param counts - The counts
+ * @param size - Number of counts
+ * @param sites - 1 if the counts are call sites, 0 if they are commands
+ */
+void printTopCounts(AllocationCount *counts, int size, char sites) {
+    //The commands are followed by the startup and the other commands
+    char shown[(TRACKING_MAX_SITES > TRACKING_MAX_COMMANDS ? TRACKING_MAX_SITES : TRACKING_MAX_COMMANDS) + 2] = {0};
+    for (int n = 0; n < TRACKING_TOP; n++) {
+        int top = -1;
+        for (int i = 0; i < size; i++) {
+            if (counts[i].file && counts[i].count && !shown[i] && (top < 0 || counts[i].bytes > counts[top].bytes)) top = i;
+        }
+        if (top < 0) return;
+        shown[top] = 1;
+        const char *name = counts[top].file;
+        for (const char *c = counts[top].file; sites && *c; c++) if (*c == '/') name = c + 1;
+        if (sites) writeFormat("\t%s:%d", name, counts[top].line);
+        else writeFormat("\t%s", name);
+        writeFormat("\t%lld allocations, %.3f MB, %.3f MB live\n", counts[top].count, (double) counts[top].bytes / 1e6, (double) counts[top].liveBytes / 1e6);
+    }
+}
+
+void printAllocationStatistics() {
+    pthread_mutex_lock(&trackingLock);
+    writeFormat("%.3f MB live, %.3f MB at peak, %lld allocations of %.3f MB since the last reset\n", (double) totalAllocations.liveBytes / 1e6,
+                (double) peakBytes / 1e6, totalAllocations.count, (double) totalAllocations.bytes / 1e6);
+    writeText("Sites allocating the most:\n");
+    printTopCounts(trackedSites, TRACKING_MAX_SITES, 1);
+    writeText("Commands allocating the most:\n");
+    AllocationCount commands[TRACKING_MAX_COMMANDS + 2];
+    for (int i = 0; i < TRACKING_MAX_COMMANDS; i++) commands[i] = trackedCommands[i];
+    commands[TRACKING_MAX_COMMANDS] = startupCommand; commands[TRACKING_MAX_COMMANDS + 1] = otherCommands;
+    printTopCounts(commands, TRACKING_MAX_COMMANDS + 2, 0);
+    pthread_mutex_unlock(&trackingLock);
+}
+
+void resetAllocationStatistics() {
+    pthread_mutex_lock(&trackingLock);
+    AllocationCount *counts[] = {trackedSites, trackedCommands, &startupCommand, &otherCommands, &totalAllocations};
+    int sizes[] = {TRACKING_MAX_SITES, TRACKING_MAX_COMMANDS, 1, 1, 1};
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < sizes[i]; j++) counts[i][j].count = counts[i][j].bytes = 0;
+    }
+    peakBytes = totalAllocations.liveBytes;
+    pthread_mutex_unlock(&trackingLock);
+    writeText("The allocation statistics were reset\n");
+}
+
+#else
+
+void trackCommand(const char *command) {
+    (void) command;
+}
+
+void printAllocationStatistics() {
+    fprintf(stderr, "Allocations are only counted when the program is built with -DTRACK_ALLOCATIONS=ON\n");
+}
+
+void resetAllocationStatistics() {
+    printAllocationStatistics();
+}
+
+#endif
\ No newline at end of file
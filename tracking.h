@@ -0,0 +1,109 @@
+/**
+ * @file tracking.h Header file of tracking.c
+ * @author Valentin Koeltgen
+ *
+ * When the program is built with TRACK_ALLOCATIONS, the allocations of the files including this header are counted by
+ * call site and by top-level command. The files implementing the allocators define ALLOCATION_IMPLEMENTATION first
+ */
+
+#ifndef LINEARALGEBRA_TRACKING_H
+#define LINEARALGEBRA_TRACKING_H
+
+#include "arena.h"
+
+#define TRACKING_MAX_SITES 4096 ///Size of the table of call sites, must be a power of 2
+#define TRACKING_MAX_COMMANDS 4096 ///Most commands counted apart, the next ones are counted together, must be a power of 2
+#define TRACKING_COMMAND_SIZE 48 ///Most characters of a command kept to name it
+#define TRACKING_TOP 10 ///Number of sites and commands displayed
+
+#define TRACKED_HEAP 0 ///Allocations of the C library
+#define TRACKED_POOL 1 ///Allocations of the pool
+#define TRACKED_TEMPORARY 2 ///Allocations of temporaries
+#define TRACKED_MALLOC 0 ///New block
+#define TRACKED_CALLOC 1 ///New block filled with zeros
+#define TRACKED_REALLOC 2 ///Resized block
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Structures
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * @struct AllocationCount
+ * Structure representing the allocations of a call site or of a command
+ */
+typedef struct {
+    const char *file; ///File of the call site, or command, NULL for an empty entry
+    int line; ///Line of the call site, 0 for a command
+    long long count; ///Number of allocations since the last reset
+    long long bytes; ///Bytes allocated since the last reset
+    long long liveBytes; ///Bytes allocated and not freed yet
+} AllocationCount;
+
+/**
+ * @struct TrackedBlock
+ * Structure representing an allocated block
+ */
+typedef struct {
+    const void *block; ///The block, NULL for an empty entry
+    size_t size; ///Number of bytes asked
+    AllocationCount *site; ///Call site of the allocation
+    AllocationCount *command; ///Top-level command of the allocation
+} TrackedBlock;
+
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// Basic operator functions
+//-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/**
+ * Allocate a counted block
+ * @param allocator - TRACKED_HEAP, TRACKED_POOL or TRACKED_TEMPORARY
+ * @param operation - TRACKED_MALLOC, TRACKED_CALLOC or TRACKED_REALLOC
+ * @param block - Block to resize
+ * @param number - Number of elements
+ * @param size - Number of bytes of an element
+ * @param file - File of the call site
+ * @param line - Line of the call site
+ * @return the allocated block
+ */
+void *trackedAllocate(int allocator, int operation, void *block, size_t number, size_t size, const char *file, int line);
+
+/**
+ * Free a counted block
+ * @param allocator - TRACKED_HEAP, TRACKED_POOL or TRACKED_TEMPORARY
+ * @param block - The block
+ */
+void trackedFree(int allocator, void *block);
+
+/**
+ * Start counting the allocations of a top-level command
+ * @param command - The command
+ */
+void trackCommand(const char *command);
+
+/**
+ * Display the allocation statistics
+ * This function display the live and peak bytes, the number of allocations and the sites and commands allocating the
+ * most bytes since the last reset
+ */
+void printAllocationStatistics();
+
+/**
+ * Reset the allocation statistics
+ * The counts start again from 0, the peak from the live bytes
+ */
+void resetAllocationStatistics();
+
+#if defined(TRACK_ALLOCATIONS) && !defined(ALLOCATION_IMPLEMENTATION)
+#define malloc(size) trackedAllocate(TRACKED_HEAP, TRACKED_MALLOC, NULL, 1, size, __FILE__, __LINE__)
+#define calloc(number, size) trackedAllocate(TRACKED_HEAP, TRACKED_CALLOC, NULL, number, size, __FILE__, __LINE__)
+#define realloc(block, size) trackedAllocate(TRACKED_HEAP, TRACKED_REALLOC, block, 1, size, __FILE__, __LINE__)
+#define free(block) trackedFree(TRACKED_HEAP, block)
+#define poolMalloc(size) trackedAllocate(TRACKED_POOL, TRACKED_MALLOC, NULL, 1, size, __FILE__, __LINE__)
+#define poolCalloc(number, size) trackedAllocate(TRACKED_POOL, TRACKED_CALLOC, NULL, number, size, __FILE__, __LINE__)
+#define poolRealloc(block, size) trackedAllocate(TRACKED_POOL, TRACKED_REALLOC, block, 1, size, __FILE__, __LINE__)
+#define poolFree(block) trackedFree(TRACKED_POOL, block)
+#define temporaryMalloc(size) trackedAllocate(TRACKED_TEMPORARY, TRACKED_MALLOC, NULL, 1, size, __FILE__, __LINE__)
+#define temporaryCalloc(number, size) trackedAllocate(TRACKED_TEMPORARY, TRACKED_CALLOC, NULL, number, size, __FILE__, __LINE__)
+#define temporaryRealloc(block, size) trackedAllocate(TRACKED_TEMPORARY, TRACKED_REALLOC, block, 1, size, __FILE__, __LINE__)
+#define temporaryFree(block) trackedFree(TRACKED_TEMPORARY, block)
+#endif
+
+#endif //LINEARALGEBRA_TRACKING_H
\ No newline at end of file
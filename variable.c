@@ -12,12 +12,15 @@ Variable newVariable(double value) {
 }
 
 void freeVariable(Variable *toFree) {
-    free(toFree); toFree = NULL;
+    if (toFree) { //A variable only owns its name
+        free(toFree->name); toFree->name = NULL;
+    }
 }
 
 void printVariable(Variable variable) {
-    if (variable.name) printf("%s = ", variable.name);
-    printf("%lf\n", variable.value);
+    if (variable.name) writeFormat("%s = ", variable.name);
+    writeNumber(variable.value, 6);
+    writeText("\n");
 }
 
 double absolute(double x) {
@@ -29,8 +32,12 @@ double power(double x, int power) {
     else if (power < 0) {
         x = 1 / x; power *= -1;
     }
-    double result = x;
-    for (int i = 1; i < power; i++) result *= x;
+    //Exponentiation by squaring
+    double result = 1;
+    while (power > 0) {
+        if (power & 1) result *= x;
+        x *= x; power >>= 1;
+    }
     return result;
 }
 
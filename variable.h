@@ -6,8 +6,7 @@
 #ifndef LINEARALGEBRA_VARIABLE_H
 #define LINEARALGEBRA_VARIABLE_H
 
-#include <stdlib.h>
-#include <stdio.h>
+#include "output.h"
 
 #define IMAGINARY 12345.54321
 